@@ -0,0 +1,295 @@
+#include "ascon32.h"
+
+#include <string.h>
+
+#define RATE_128 8
+#define RATE_128A 16
+
+/* Ascon-128 and Ascon-128a IVs as bytes, to stay clear of 64-bit math */
+static const uint8_t IV_128[8] = {0x80, 0x40, 0x0c, 0x06, 0, 0, 0, 0};
+static const uint8_t IV_128A[8] = {0x80, 0x80, 0x0c, 0x08, 0, 0, 0, 0};
+
+/* round constants 0xf0, 0xe1, ..., 0x4b split into even and odd bits */
+static const uint8_t RC[12][2] = {
+    {0xc, 0xc}, {0x9, 0xc}, {0xc, 0x9}, {0x9, 0x9}, {0x6, 0xc}, {0x3, 0xc},
+    {0x6, 0x9}, {0x3, 0x9}, {0xc, 0x6}, {0x9, 0x6}, {0xc, 0x3}, {0x9, 0x3}};
+
+static inline uint32_t ROR32(uint32_t x, int n) {
+  return x >> n | x << (-n & 31);
+}
+
+/* 64-bit rotation by n in the interleaved representation */
+static inline ascon32_word_t ROR_BI(ascon32_word_t x, int n) {
+  ascon32_word_t r;
+  if (n & 1) {
+    r.e = ROR32(x.o, (n - 1) / 2);
+    r.o = ROR32(x.e, (n + 1) / 2);
+  } else {
+    r.e = ROR32(x.e, n / 2);
+    r.o = ROR32(x.o, n / 2);
+  }
+  return r;
+}
+
+/* even bits to the lower, odd bits to the upper half (Hacker's Delight) */
+static uint32_t deinterleave16(uint32_t x) {
+  uint32_t t;
+  t = (x ^ (x >> 1)) & 0x22222222, x ^= t ^ (t << 1);
+  t = (x ^ (x >> 2)) & 0x0C0C0C0C, x ^= t ^ (t << 2);
+  t = (x ^ (x >> 4)) & 0x00F000F0, x ^= t ^ (t << 4);
+  t = (x ^ (x >> 8)) & 0x0000FF00, x ^= t ^ (t << 8);
+  return x;
+}
+
+static uint32_t interleave16(uint32_t x) {
+  uint32_t t;
+  t = (x ^ (x >> 8)) & 0x0000FF00, x ^= t ^ (t << 8);
+  t = (x ^ (x >> 4)) & 0x00F000F0, x ^= t ^ (t << 4);
+  t = (x ^ (x >> 2)) & 0x0C0C0C0C, x ^= t ^ (t << 2);
+  t = (x ^ (x >> 1)) & 0x22222222, x ^= t ^ (t << 1);
+  return x;
+}
+
+ascon32_word_t ascon32_load(const uint8_t* bytes) {
+  uint32_t hi = (uint32_t)bytes[0] << 24 | (uint32_t)bytes[1] << 16 |
+                (uint32_t)bytes[2] << 8 | bytes[3];
+  uint32_t lo = (uint32_t)bytes[4] << 24 | (uint32_t)bytes[5] << 16 |
+                (uint32_t)bytes[6] << 8 | bytes[7];
+  ascon32_word_t w;
+  hi = deinterleave16(hi);
+  lo = deinterleave16(lo);
+  w.e = (lo & 0x0000FFFF) | (hi << 16);
+  w.o = (lo >> 16) | (hi & 0xFFFF0000);
+  return w;
+}
+
+void ascon32_store(uint8_t* bytes, ascon32_word_t w) {
+  uint32_t lo = (w.e & 0x0000FFFF) | (w.o << 16);
+  uint32_t hi = (w.e >> 16) | (w.o & 0xFFFF0000);
+  int i;
+  lo = interleave16(lo);
+  hi = interleave16(hi);
+  for (i = 0; i < 4; i++) {
+    bytes[i] = (uint8_t)(hi >> (24 - 8 * i));
+    bytes[4 + i] = (uint8_t)(lo >> (24 - 8 * i));
+  }
+}
+
+static inline void XOR(ascon32_word_t* x, ascon32_word_t y) {
+  x->e ^= y.e;
+  x->o ^= y.o;
+}
+
+/* same round as round.h, once on the even and once on the odd halves */
+static void ROUND(ascon32_state_t* s, const uint8_t* C) {
+  ascon32_word_t t[5];
+  uint32_t* h[5];
+  int half, i;
+
+  for (half = 0; half < 2; half++) {
+    uint32_t x0, x1, x2, x3, x4, t0, t1, t2, t3, t4;
+    for (i = 0; i < 5; i++) h[i] = half ? &s->x[i].o : &s->x[i].e;
+    x0 = *h[0];
+    x1 = *h[1];
+    x2 = *h[2] ^ C[half];
+    x3 = *h[3];
+    x4 = *h[4];
+    /* substitution layer */
+    x0 ^= x4;
+    x4 ^= x3;
+    x2 ^= x1;
+    t0 = x0 ^ (~x1 & x2);
+    t1 = x1 ^ (~x2 & x3);
+    t2 = x2 ^ (~x3 & x4);
+    t3 = x3 ^ (~x4 & x0);
+    t4 = x4 ^ (~x0 & x1);
+    t1 ^= t0;
+    t0 ^= t4;
+    t3 ^= t2;
+    t2 = ~t2;
+    *h[0] = t0;
+    *h[1] = t1;
+    *h[2] = t2;
+    *h[3] = t3;
+    *h[4] = t4;
+  }
+  /* linear diffusion layer */
+  for (i = 0; i < 5; i++) t[i] = s->x[i];
+  XOR(&s->x[0], ROR_BI(t[0], 19));
+  XOR(&s->x[0], ROR_BI(t[0], 28));
+  XOR(&s->x[1], ROR_BI(t[1], 61));
+  XOR(&s->x[1], ROR_BI(t[1], 39));
+  XOR(&s->x[2], ROR_BI(t[2], 1));
+  XOR(&s->x[2], ROR_BI(t[2], 6));
+  XOR(&s->x[3], ROR_BI(t[3], 10));
+  XOR(&s->x[3], ROR_BI(t[3], 17));
+  XOR(&s->x[4], ROR_BI(t[4], 7));
+  XOR(&s->x[4], ROR_BI(t[4], 41));
+}
+
+void ascon32_permute(ascon32_state_t* s, int rounds) {
+  int i;
+  for (i = 12 - rounds; i < 12; i++) ROUND(s, RC[i]);
+}
+
+/* the n < 8 bytes of a last block with the 0x80 padding byte after them */
+static ascon32_word_t load_padded(const uint8_t* bytes, int n) {
+  uint8_t b[8];
+  memset(b, 0, sizeof(b));
+  memcpy(b, bytes, n);
+  b[n] = 0x80;
+  return ascon32_load(b);
+}
+
+static void ascon32_init(ascon32_state_t* s, const uint8_t* iv,
+                         ascon32_word_t K0, ascon32_word_t K1,
+                         const uint8_t* npub) {
+  s->x[0] = ascon32_load(iv);
+  s->x[1] = K0;
+  s->x[2] = K1;
+  s->x[3] = ascon32_load(npub);
+  s->x[4] = ascon32_load(npub + 8);
+  ascon32_permute(s, 12);
+  XOR(&s->x[3], K0);
+  XOR(&s->x[4], K1);
+}
+
+static void ascon32_adata(ascon32_state_t* s, const uint8_t* ad,
+                          unsigned long long adlen, int rate) {
+  int rounds = rate == RATE_128A ? 8 : 6;
+  if (adlen) {
+    /* full associated data blocks */
+    while (adlen >= (unsigned long long)rate) {
+      XOR(&s->x[0], ascon32_load(ad));
+      if (rate == RATE_128A) XOR(&s->x[1], ascon32_load(ad + 8));
+      ascon32_permute(s, rounds);
+      ad += rate;
+      adlen -= rate;
+    }
+    /* final associated data block */
+    if (adlen >= 8) {
+      XOR(&s->x[0], ascon32_load(ad));
+      XOR(&s->x[1], load_padded(ad + 8, (int)adlen - 8));
+    } else {
+      XOR(&s->x[0], load_padded(ad, (int)adlen));
+    }
+    ascon32_permute(s, rounds);
+  }
+  /* domain separation */
+  s->x[4].e ^= 1;
+}
+
+static void ascon32_final(ascon32_state_t* s, ascon32_word_t K0,
+                          ascon32_word_t K1, int rate) {
+  XOR(&s->x[rate == RATE_128A ? 2 : 1], K0);
+  XOR(&s->x[rate == RATE_128A ? 3 : 2], K1);
+  ascon32_permute(s, 12);
+  XOR(&s->x[3], K0);
+  XOR(&s->x[4], K1);
+}
+
+/* Partial last block: go through bytes, it happens once per message.
+ * Encryption xors the plaintext into the state; decryption replaces the
+ * state bytes with the ciphertext. Then the padding byte is added. */
+static void last_block(ascon32_state_t* s, uint8_t* out, const uint8_t* in,
+                       int len, int decrypt) {
+  uint8_t b[16];
+  int i;
+  ascon32_store(b, s->x[0]);
+  ascon32_store(b + 8, s->x[1]);
+  for (i = 0; i < len; i++) {
+    uint8_t c = in[i];
+    out[i] = b[i] ^ c;
+    b[i] = decrypt ? c : out[i];
+  }
+  b[len] ^= 0x80;
+  s->x[0] = ascon32_load(b);
+  if (len >= 8) s->x[1] = ascon32_load(b + 8);
+}
+
+static int ascon32_aead(unsigned char* out, const unsigned char* in,
+                        unsigned long long len, const unsigned char* ad,
+                        unsigned long long adlen, const unsigned char* npub,
+                        const unsigned char* k, int rate, int decrypt) {
+  const ascon32_word_t K0 = ascon32_load(k);
+  const ascon32_word_t K1 = ascon32_load(k + 8);
+  int rounds = rate == RATE_128A ? 8 : 6;
+  ascon32_state_t s;
+  uint8_t tag[ASCON32_ABYTES];
+  int i, result = 0;
+
+  ascon32_init(&s, rate == RATE_128A ? IV_128A : IV_128, K0, K1, npub);
+  ascon32_adata(&s, ad, adlen, rate);
+  /* full blocks */
+  while (len >= (unsigned long long)rate) {
+    for (i = 0; i < rate; i += 8) {
+      ascon32_word_t w = ascon32_load(in + i);
+      if (decrypt) {
+        XOR(&s.x[i / 8], w);
+        ascon32_store(out + i, s.x[i / 8]);
+        s.x[i / 8] = w;
+      } else {
+        XOR(&s.x[i / 8], w);
+        ascon32_store(out + i, s.x[i / 8]);
+      }
+    }
+    ascon32_permute(&s, rounds);
+    in += rate;
+    out += rate;
+    len -= rate;
+  }
+  last_block(&s, out, in, (int)len, decrypt);
+  ascon32_final(&s, K0, K1, rate);
+
+  /* get or verify tag */
+  ascon32_store(tag, s.x[3]);
+  ascon32_store(tag + 8, s.x[4]);
+  if (!decrypt) {
+    memcpy(out + len, tag, ASCON32_ABYTES);
+    return 0;
+  }
+  for (i = 0; i < ASCON32_ABYTES; i++) result |= in[len + i] ^ tag[i];
+  return (((result - 1) >> 8) & 1) - 1;
+}
+
+int ascon32_128_encrypt(unsigned char* c, unsigned long long* clen,
+                        const unsigned char* m, unsigned long long mlen,
+                        const unsigned char* ad, unsigned long long adlen,
+                        const unsigned char* nsec, const unsigned char* npub,
+                        const unsigned char* k) {
+  (void)nsec;
+  *clen = mlen + ASCON32_ABYTES;
+  return ascon32_aead(c, m, mlen, ad, adlen, npub, k, RATE_128, 0);
+}
+
+int ascon32_128_decrypt(unsigned char* m, unsigned long long* mlen,
+                        unsigned char* nsec, const unsigned char* c,
+                        unsigned long long clen, const unsigned char* ad,
+                        unsigned long long adlen, const unsigned char* npub,
+                        const unsigned char* k) {
+  (void)nsec;
+  if (clen < ASCON32_ABYTES) return -1;
+  *mlen = clen - ASCON32_ABYTES;
+  return ascon32_aead(m, c, *mlen, ad, adlen, npub, k, RATE_128, 1);
+}
+
+int ascon32_128a_encrypt(unsigned char* c, unsigned long long* clen,
+                         const unsigned char* m, unsigned long long mlen,
+                         const unsigned char* ad, unsigned long long adlen,
+                         const unsigned char* nsec,
+                         const unsigned char* npub, const unsigned char* k) {
+  (void)nsec;
+  *clen = mlen + ASCON32_ABYTES;
+  return ascon32_aead(c, m, mlen, ad, adlen, npub, k, RATE_128A, 0);
+}
+
+int ascon32_128a_decrypt(unsigned char* m, unsigned long long* mlen,
+                         unsigned char* nsec, const unsigned char* c,
+                         unsigned long long clen, const unsigned char* ad,
+                         unsigned long long adlen, const unsigned char* npub,
+                         const unsigned char* k) {
+  (void)nsec;
+  if (clen < ASCON32_ABYTES) return -1;
+  *mlen = clen - ASCON32_ABYTES;
+  return ascon32_aead(m, c, *mlen, ad, adlen, npub, k, RATE_128A, 1);
+}
@@ -0,0 +1,56 @@
+#ifndef ASCON32_H_
+#define ASCON32_H_
+
+#include <stdint.h>
+
+/* Ascon for 32-bit cores such as the MicroBlaze. Every 64-bit Ascon word is
+ * kept bit-interleaved: e holds its even bits and o its odd bits. A 64-bit
+ * rotation then becomes two 32-bit rotations (swapping the halves for odd
+ * amounts) and the s-box works on the halves independently, so no 64-bit
+ * shifts are needed anywhere. Output is identical to the 64-bit code in
+ * GROUP H/ASCON (checked there with ascon32_check.c). */
+
+#define ASCON32_KEYBYTES 16
+#define ASCON32_NPUBBYTES 16
+#define ASCON32_ABYTES 16
+
+typedef struct {
+  uint32_t e; /* bits 0, 2, ..., 62 */
+  uint32_t o; /* bits 1, 3, ..., 63 */
+} ascon32_word_t;
+
+typedef struct {
+  ascon32_word_t x[5];
+} ascon32_state_t;
+
+/* 8 bytes (big-endian Ascon word) <-> bit-interleaved word */
+ascon32_word_t ascon32_load(const uint8_t* bytes);
+void ascon32_store(uint8_t* bytes, ascon32_word_t w);
+
+/* the last rounds of the permutation: 12, 8 or 6 */
+void ascon32_permute(ascon32_state_t* s, int rounds);
+
+/* Ascon-128 and Ascon-128a, same interface as crypto_aead_encrypt and
+ * crypto_aead_decrypt; c == m is allowed */
+int ascon32_128_encrypt(unsigned char* c, unsigned long long* clen,
+                        const unsigned char* m, unsigned long long mlen,
+                        const unsigned char* ad, unsigned long long adlen,
+                        const unsigned char* nsec, const unsigned char* npub,
+                        const unsigned char* k);
+int ascon32_128_decrypt(unsigned char* m, unsigned long long* mlen,
+                        unsigned char* nsec, const unsigned char* c,
+                        unsigned long long clen, const unsigned char* ad,
+                        unsigned long long adlen, const unsigned char* npub,
+                        const unsigned char* k);
+int ascon32_128a_encrypt(unsigned char* c, unsigned long long* clen,
+                         const unsigned char* m, unsigned long long mlen,
+                         const unsigned char* ad, unsigned long long adlen,
+                         const unsigned char* nsec,
+                         const unsigned char* npub, const unsigned char* k);
+int ascon32_128a_decrypt(unsigned char* m, unsigned long long* mlen,
+                         unsigned char* nsec, const unsigned char* c,
+                         unsigned long long clen, const unsigned char* ad,
+                         unsigned long long adlen, const unsigned char* npub,
+                         const unsigned char* k);
+
+#endif /* ASCON32_H_ */
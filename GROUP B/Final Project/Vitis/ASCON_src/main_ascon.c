@@ -0,0 +1,264 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "port.h"
+#include "energy.h"
+#include "ascon32.h"  // Bit-interleaved 32-bit Ascon-128/Ascon-128a
+
+#define MAX_INPUT_SIZE 256
+#define MAX_PRINT_BYTES 64        // Longer ciphertexts are not printed
+
+typedef int (*EncryptFunc)(unsigned char*, unsigned long long*, const unsigned char*, unsigned long long,
+                           const unsigned char*, unsigned long long, const unsigned char*,
+                           const unsigned char*, const unsigned char*);
+typedef int (*DecryptFunc)(unsigned char*, unsigned long long*, unsigned char*, const unsigned char*,
+                           unsigned long long, const unsigned char*, unsigned long long,
+                           const unsigned char*, const unsigned char*);
+
+typedef struct {
+    const char *name;
+    EncryptFunc encrypt;
+    DecryptFunc decrypt;
+} AsconVariant;
+
+static const AsconVariant variants[] = {
+    { "Ascon-128", ascon32_128_encrypt, ascon32_128_decrypt },
+    { "Ascon-128a", ascon32_128a_encrypt, ascon32_128a_decrypt },
+};
+
+// Known answers for key = nonce = 00 01 .. 0f, from the 64-bit code in GROUP H/ASCON:
+// empty message and AD, then message = AD = 00 01 .. 0f (ciphertext || tag)
+static const u8 kat_empty[2][ASCON32_ABYTES] = {
+    { 0xe3, 0x55, 0x15, 0x9f, 0x29, 0x29, 0x11, 0xf7, 0x94, 0xcb, 0x14, 0x32, 0xa0, 0x10, 0x3a, 0x8a },
+    { 0x7a, 0x83, 0x4e, 0x6f, 0x09, 0x21, 0x09, 0x57, 0x06, 0x7b, 0x10, 0xfd, 0x83, 0x1f, 0x00, 0x78 },
+};
+static const u8 kat_16[2][16 + ASCON32_ABYTES] = {
+    { 0x1e, 0xe3, 0x41, 0x25, 0xfd, 0xba, 0x17, 0x44, 0x3d, 0x01, 0xda, 0x8a, 0x0e, 0xef, 0xb0, 0x45,
+      0x42, 0x81, 0xd1, 0xd3, 0xb9, 0x62, 0x41, 0x8d, 0x2e, 0x1c, 0x8a, 0x6d, 0x14, 0xf3, 0xe8, 0xa2 },
+    { 0x52, 0x49, 0x9a, 0xc9, 0xc8, 0x43, 0x23, 0xa4, 0xae, 0x24, 0xea, 0xec, 0xcf, 0x45, 0xc1, 0x37,
+      0x31, 0x6d, 0x7a, 0xb1, 0x77, 0x24, 0xba, 0x67, 0xa8, 0x5e, 0xcd, 0x3c, 0x04, 0x57, 0xc4, 0x59 },
+};
+
+static void print_hex(const char *label, const u8 *data, size_t len) {
+    char hex[2 * (MAX_PRINT_BYTES + ASCON32_ABYTES) + 1];
+    memset(hex, 0, sizeof(hex));
+    for (size_t i = 0; i < len; i++) {
+        sprintf(hex + i * 2, "%02x", data[i]);
+    }
+    port_printf("%s: %s\n\r", label, hex);
+}
+
+// Fixed test key and nonce; a real application needs a fresh nonce per message
+static void test_key_nonce(u8 *key, u8 *nonce) {
+    for (int i = 0; i < ASCON32_KEYBYTES; i++) {
+        key[i] = (u8)i;
+        nonce[i] = (u8)i;
+    }
+}
+
+// Output buffer of encrypt_ascon(), at least as large as the message plus the tag
+static u8 *energy_out;
+
+// Encryption only, with the test key and nonce; the RAPL backend of energy.c repeats it
+static int encrypt_ascon(int variant, const u8 *data, size_t len) {
+    u8 key[ASCON32_KEYBYTES], nonce[ASCON32_NPUBBYTES];
+    unsigned long long clen;
+    test_key_nonce(key, nonce);
+    return variants[variant - 1].encrypt(energy_out, &clen, data, len, NULL, 0, NULL, nonce, key);
+}
+
+// Encrypts all four known answer vectors and decrypts them again
+void run_self_test(void) {
+    u8 key[ASCON32_KEYBYTES], nonce[ASCON32_NPUBBYTES], msg[16], plain[16], out[16 + ASCON32_ABYTES];
+    unsigned long long len;
+    int failures = 0;
+
+    test_key_nonce(key, nonce);
+    for (int i = 0; i < 16; i++) {
+        msg[i] = (u8)i;
+    }
+
+    port_printf("Running Known Answer Self-Test\n\r");
+    for (int v = 0; v < 2; v++) {
+        variants[v].encrypt(out, &len, msg, 0, msg, 0, NULL, nonce, key);
+        int ok = memcmp(out, kat_empty[v], ASCON32_ABYTES) == 0 &&
+                 variants[v].decrypt(plain, &len, NULL, out, ASCON32_ABYTES, msg, 0, nonce, key) == 0;
+        variants[v].encrypt(out, &len, msg, 16, msg, 16, NULL, nonce, key);
+        ok = ok && memcmp(out, kat_16[v], sizeof(kat_16[v])) == 0;
+        out[0] ^= 1; // must be rejected
+        ok = ok && variants[v].decrypt(plain, &len, NULL, out, sizeof(kat_16[v]), msg, 16, nonce, key) != 0;
+        port_printf("%s: %s\n\r", variants[v].name, ok ? "PASS" : "FAIL");
+        failures += !ok;
+    }
+    port_printf(failures ? "Self-test FAILED\n\r" : "Self-test passed\n\r");
+}
+
+void run_test_case(int ascon_variant, int test_type) {
+    const AsconVariant *variant = &variants[ascon_variant - 1];
+    u8 key[ASCON32_KEYBYTES], nonce[ASCON32_NPUBBYTES];
+    char *data;
+    size_t data_size = 0;
+
+    switch (test_type) {
+        case 1: { // Functional Test
+            port_printf("Enter the input data (max %d characters):\n\r", MAX_INPUT_SIZE - 1);
+            data = (char *)port_malloc(MAX_INPUT_SIZE);
+            char c;
+            int i = 0;
+            while (i < MAX_INPUT_SIZE - 1) {
+                c = port_getc();
+                if (c == '\r' || c == '\n') {
+                    break;
+                }
+                data[i++] = c;
+                port_putc(c);
+            }
+            data[i] = '\0';
+            data_size = strlen(data);
+            port_printf("\n\rRunning Functional Test:\n\r");
+            break;
+        }
+        case 2: { // Edge Case
+            data = (char *)port_malloc(1);
+            data[0] = '\0';
+            data_size = 0;
+            port_printf("Running Edge Case Test (Empty Input)\n\r");
+            break;
+        }
+        case 3: { // Performance Test
+            port_printf("Choose Performance Test:\n\r");
+            port_printf("1: 1 KB Input\n\r");
+            port_printf("2: 1 MB Input\n\r");
+
+            char choice = port_getc();
+            port_putc(choice);
+            port_printf("\n\r");
+
+            if (choice == '1') {
+                data_size = 1024; // 1 KB
+            } else if (choice == '2') {
+                data_size = 1024 * 1024; // 1 MB
+            } else {
+                port_printf("Invalid choice. Returning to main menu.\n\r");
+                return;
+            }
+
+            data = (char *)port_malloc(data_size);
+            memset(data, 'A', data_size);
+            port_printf("Running Performance Test(%lu bytes)\n\r", (unsigned long)data_size);
+            break;
+        }
+        default:
+            port_printf("Invalid test case.\n\r");
+            return;
+    }
+
+    u8 *ciphertext = (u8 *)port_malloc(data_size + ASCON32_ABYTES);
+    u8 *plaintext = (u8 *)port_malloc(data_size + 1);
+    if (!data || !ciphertext || !plaintext) {
+        port_printf("Out of memory.\n\r");
+        port_free(data);
+        port_free(ciphertext);
+        port_free(plaintext);
+        return;
+    }
+    unsigned long long clen, mlen;
+    test_key_nonce(key, nonce);
+
+    // Measure execution time of the encryption only, printing is done afterwards
+    port_timer_start();
+
+    variant->encrypt(ciphertext, &clen, (const u8 *)data, data_size, NULL, 0, NULL, nonce, key);
+
+    u64 elapsed_cycles = port_timer_stop();
+    elapsed_cycles = elapsed_cycles > port_timer_overhead() ? elapsed_cycles - port_timer_overhead() : 0;
+
+    int verified = variant->decrypt(plaintext, &mlen, NULL, ciphertext, clen, NULL, 0, nonce, key) == 0 &&
+                   mlen == data_size && memcmp(plaintext, data, data_size) == 0;
+
+    port_printf("%s\n\r", variant->name);
+    if (data_size <= MAX_PRINT_BYTES) {
+        print_hex("Ciphertext", ciphertext, data_size);
+    }
+    print_hex("Tag", ciphertext + data_size, ASCON32_ABYTES);
+    port_printf("Decryption: %s\n\r", verified ? "tag valid, plaintext matches" : "FAILED");
+
+    u64 execution_time_us = (elapsed_cycles * 1000000) / port_timer_hz();
+    u64 throughput_bps = elapsed_cycles ? ((u64)data_size * port_timer_hz()) / elapsed_cycles : 0;
+    energy_out = ciphertext;
+    u64 energy_nj = energy_per_hash_nj(encrypt_ascon, ascon_variant, (const u8 *)data, data_size, elapsed_cycles);
+
+    port_printf("Estimated Memory Usage: %lu bytes\n\r",
+               (unsigned long)(2 * data_size + ASCON32_ABYTES + sizeof(ascon32_state_t)));
+    port_printf("Elapsed Cycles: %lu\n\r", (unsigned long)elapsed_cycles);
+    if (data_size) {
+        port_printf("Cycles per Byte: %lu\n\r", (unsigned long)(elapsed_cycles / data_size));
+    }
+    port_printf("Execution Time: %lu microseconds\n\r", (unsigned long)execution_time_us);
+    port_printf("Throughput: %lu bytes/second\n\r", (unsigned long)throughput_bps);
+    energy_print(energy_nj, data_size);
+
+    port_free(data);
+    port_free(ciphertext);
+    port_free(plaintext);
+}
+
+int main() {
+    port_init();
+    port_printf("Timer: %s, %lu ticks per second\n\r", port_name(), (unsigned long)port_timer_hz());
+    energy_init("ASCON");
+    port_printf("Energy: %s\n\r", energy_source());
+
+    while (1) {
+        port_printf("\n\r=== Ascon Tests ===\n\r");
+        port_printf("Select Ascon Variant:\n\r");
+        port_printf("1: Ascon-128\n\r");
+        port_printf("2: Ascon-128a\n\r");
+        port_printf("0: Exit\n\r");
+
+        char variant_choice = port_getc();
+        port_putc(variant_choice);
+        port_printf("\n\r");
+
+        int ascon_variant = variant_choice - '0';
+        if (ascon_variant == 0) {
+            port_printf("Exiting program. Goodbye!\n\r");
+            break;
+        }
+        if (ascon_variant < 1 || ascon_variant > 2) {
+            port_printf("Invalid choice. Try again.\n\r");
+            continue;
+        }
+
+        port_printf("Select Test Type:\n\r");
+        port_printf("1: Functional Test\n\r");
+        port_printf("2: Edge Case Test (Empty Input)\n\r");
+        port_printf("3: Performance Test\n\r");
+        port_printf("4: Known Answer Self-Test (both variants)\n\r");
+        port_printf("0: Return to Main Menu\n\r");
+
+        char test_choice = port_getc();
+        port_putc(test_choice);
+        port_printf("\n\r");
+
+        int test_type = test_choice - '0';
+        if (test_type == 0) {
+            port_printf("Returning to main menu.\n\r");
+            continue;
+        }
+        if (test_type < 1 || test_type > 4) {
+            port_printf("Invalid choice. Try again.\n\r");
+            continue;
+        }
+
+        if (test_type == 4) {
+            run_self_test();
+            continue;
+        }
+
+        run_test_case(ascon_variant, test_type);
+    }
+
+    port_cleanup();
+    return 0;
+}
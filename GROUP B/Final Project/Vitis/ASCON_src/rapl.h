@@ -0,0 +1,41 @@
+#ifndef RAPL_H_
+#define RAPL_H_
+
+#include <stdint.h>
+
+/* Energy counter of a Linux powercap zone (Intel and AMD RAPL), plain C
+ * without the benchmark or port layers. On other systems rapl_open()
+ * fails and callers report the energy as not available.
+ *
+ * The zone is ENERGY_RAPL_ZONE from the environment, or
+ * /sys/class/powercap/intel-rapl:0 (the CPU package); energy_uj is readable
+ * by root only on recent kernels. The counter covers the whole package and
+ * is updated about once a millisecond, so an interval has to be much longer
+ * than that. Most of what the package draws while one core runs a
+ * benchmark is its idle power: rapl_measure_idle() takes that baseline
+ * once, and rapl_active_uj() subtracts it from every interval. */
+
+#define RAPL_IDLE_MS 250 /* default length of the idle measurement */
+
+typedef struct {
+  char zone[96];
+  uint64_t range_uj; /* the counter wraps at this value, 0 if unknown */
+  double idle_mw;    /* from rapl_measure_idle(), 0 before */
+} rapl_t;
+
+/* 0, or -1 if the counter cannot be read */
+int rapl_open(rapl_t* r);
+
+/* counter in microjoules; 0, or -1 if it cannot be read */
+int rapl_read(const rapl_t* r, uint64_t* uj);
+
+/* Sleeps ms milliseconds and sets idle_mw to the average power of the zone
+ * meanwhile. Call it before the benchmark starts any threads. */
+int rapl_measure_idle(rapl_t* r, unsigned ms);
+
+/* Microjoules above the idle baseline between two readings taken seconds
+ * apart, 0 if the baseline is higher */
+double rapl_active_uj(const rapl_t* r, uint64_t before, uint64_t after,
+                      double seconds);
+
+#endif /* RAPL_H_ */
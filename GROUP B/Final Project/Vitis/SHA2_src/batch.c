@@ -0,0 +1,207 @@
+#include <errno.h>
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "batch.h"
+#include "energy.h"
+
+// Decimal number without sign; -1 if it does not fit into an unsigned long
+static int parse_number(const char *p, char **end, unsigned long *value) {
+    if (*p < '0' || *p > '9') return -1;
+    errno = 0;
+    *value = strtoul(p, end, 10);
+    return errno == ERANGE ? -1 : 0;
+}
+
+static int parse_list(const char *p, unsigned long *values, int max_values, int sizes) {
+    int n = 0;
+    while (*p) {
+        char *end;
+        unsigned long first, last, factor = 1;
+        if (parse_number(p, &end, &first)) return -1;
+        if (sizes && (*end == 'k' || *end == 'K')) {
+            factor = 1024;
+            end++;
+        } else if (sizes && (*end == 'm' || *end == 'M')) {
+            factor = 1024 * 1024;
+            end++;
+        }
+        // unsigned long is 32 bits on MicroBlaze: 4096M would wrap around to 0
+        if (first > ULONG_MAX / factor) return -1;
+        first *= factor;
+        last = first;
+        if (!sizes && *end == '-') { // variant range
+            p = end + 1;
+            if (parse_number(p, &end, &last) || last < first) return -1;
+        }
+        for (; first <= last; first++) {
+            if (n == max_values) return -1;
+            values[n++] = first;
+        }
+        if (*end == ',') end++;
+        else if (*end) return -1;
+        p = end;
+    }
+    return n;
+}
+
+static int parse_fields(batch_spec *spec, const char *text, int num_variants) {
+    char field[BATCH_MAX_SPEC];
+    unsigned long values[BATCH_MAX_SIZES];
+
+    while (*text) {
+        if (*text == ' ' || *text == '\t') {
+            text++;
+            continue;
+        }
+        size_t len = strcspn(text, " \t");
+        if (len >= sizeof(field)) len = sizeof(field) - 1;
+        memcpy(field, text, len);
+        field[len] = '\0';
+        text += len;
+        if (len < 3 || field[1] != '=') goto bad;
+        char *value = field + 2;
+
+        switch (field[0]) {
+            case 'v': {
+                int n = parse_list(value, values, BATCH_MAX_VARIANTS, 0);
+                if (n <= 0) goto bad;
+                for (int i = 0; i < n; i++) {
+                    if (values[i] < 1 || values[i] > (unsigned long)num_variants) goto bad;
+                    spec->variants[i] = (int)values[i];
+                }
+                spec->num_variants = n;
+                break;
+            }
+            case 's': {
+                int n = parse_list(value, values, BATCH_MAX_SIZES, 1);
+                if (n <= 0) goto bad;
+                for (int i = 0; i < n; i++) {
+                    spec->sizes[i] = values[i];
+                }
+                spec->num_sizes = n;
+                break;
+            }
+            case 'r': {
+                char *end;
+                unsigned long reps = strtoul(value, &end, 10);
+                if (end == value || *end || reps < 1 || reps > BATCH_MAX_REPS) goto bad;
+                spec->reps = (int)reps;
+                break;
+            }
+            default:
+                goto bad;
+        }
+        continue;
+    bad:
+        port_printf("Bad field in spec: %s (variants 1-%d, at most %d variants and %d sizes, 1-%d repetitions)\n\r",
+                    field, num_variants, BATCH_MAX_VARIANTS, BATCH_MAX_SIZES, BATCH_MAX_REPS);
+        return -1;
+    }
+    return 0;
+}
+
+int batch_parse(batch_spec *spec, const char *text, int num_variants) {
+    memset(spec, 0, sizeof(*spec));
+    if (parse_fields(spec, BATCH_DEFAULT_SPEC, num_variants) != 0 ||
+        parse_fields(spec, text, num_variants) != 0) {
+        return -1;
+    }
+    if (spec->num_variants == 0 || spec->num_sizes == 0 || spec->reps == 0) {
+        port_printf("Spec needs v=, s= and r= fields.\n\r");
+        return -1;
+    }
+    return 0;
+}
+
+void batch_read_spec(char *text, int size) {
+    int i = 0;
+    while (i < size - 1) {
+        char c = port_getc();
+        if (c == '\r' || c == '\n') break;
+        if (c == '\b' || c == 0x7f) { // backspace on a terminal
+            if (i > 0) {
+                i--;
+                port_printf("\b \b");
+            }
+            continue;
+        }
+        text[i++] = c;
+        port_putc(c);
+    }
+    text[i] = '\0';
+    port_printf("\n\r");
+    if (i == 0) {
+        strncpy(text, BATCH_DEFAULT_SPEC, size - 1);
+        text[size - 1] = '\0';
+    }
+}
+
+static void sort_ticks(u64 *v, int n) {
+    for (int i = 1; i < n; i++) {
+        u64 x = v[i];
+        int j = i - 1;
+        while (j >= 0 && v[j] > x) {
+            v[j + 1] = v[j];
+            j--;
+        }
+        v[j + 1] = x;
+    }
+}
+
+int batch_run(const batch_spec *spec, const char *const *names, batch_hash_fn hash) {
+    size_t max_size = 0;
+    for (int s = 0; s < spec->num_sizes; s++) {
+        if (spec->sizes[s] > max_size) max_size = spec->sizes[s];
+    }
+    u8 *data = (u8 *)port_malloc(max_size ? max_size : 1);
+    u64 *samples = (u64 *)port_malloc(spec->reps * sizeof(u64));
+    if (!data || !samples) {
+        port_printf("Batch: cannot allocate %lu bytes.\n\r", (unsigned long)max_size);
+        port_free(data);
+        port_free(samples);
+        return -1;
+    }
+    memset(data, 'A', max_size);
+
+    port_printf("# timer: %s, %lu ticks per second, %lu ticks overhead subtracted\n\r", port_name(),
+                (unsigned long)port_timer_hz(), (unsigned long)port_timer_overhead());
+    port_printf("# energy: %s\n\r", energy_source());
+    port_printf("variant,bytes,reps,min_cycles,median_cycles,max_cycles,nj_per_hash,pj_per_byte\n\r");
+    for (int v = 0; v < spec->num_variants; v++) {
+        for (int s = 0; s < spec->num_sizes; s++) {
+            int variant = spec->variants[v];
+            size_t size = spec->sizes[s];
+            if (hash(variant, data, size) != 0) { // warm up
+                port_printf("# %s failed, skipped\n\r", names[variant - 1]);
+                continue;
+            }
+            for (int r = 0; r < spec->reps; r++) {
+                port_timer_start();
+                hash(variant, data, size);
+                u64 ticks = port_timer_stop(); // less the cost of reading the timer, as phase_ticks()
+                samples[r] = ticks > port_timer_overhead() ? ticks - port_timer_overhead() : 0;
+            }
+            sort_ticks(samples, spec->reps);
+            port_printf("%s,%lu,%d,%lu,%lu,%lu", names[variant - 1], (unsigned long)size, spec->reps,
+                        (unsigned long)samples[0], (unsigned long)samples[spec->reps / 2],
+                        (unsigned long)samples[spec->reps - 1]);
+
+            // energy of a median hash; empty fields when unknown
+            u64 energy_nj = energy_per_hash_nj(hash, variant, data, size, samples[spec->reps / 2]);
+            u64 pj_per_byte = energy_per_byte_pj(energy_nj, size);
+            if (energy_nj == ENERGY_UNKNOWN) {
+                port_printf(",,\n\r");
+            } else if (pj_per_byte == ENERGY_UNKNOWN) {
+                port_printf(",%lu,\n\r", (unsigned long)energy_nj);
+            } else {
+                port_printf(",%lu,%lu\n\r", (unsigned long)energy_nj, (unsigned long)pj_per_byte);
+            }
+        }
+    }
+    port_printf("# end\n\r");
+
+    port_free(samples);
+    port_free(data);
+    return 0;
+}
@@ -0,0 +1,151 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "energy.h"
+#include "rapl.h"
+
+// Power while hashing above the idle power, the same quantity RAPL gives after its baseline is
+// subtracted. Entries come from the calibration described in energy.h.
+typedef struct {
+    const char *platform;
+    const char *algorithm;
+    u64 power_mw;
+    int calibrated; // 0: not measured against this code
+} energy_model;
+
+// The MicroBlaze entries are the DYNAMIC_POWER_MW constants the drivers had; they were never
+// measured, so they stay marked until a board calibration replaces them.
+static const energy_model models[] = {
+    { "MicroBlaze", "SHA-2", 1111, 0 },
+    { "MicroBlaze", "SHA-3", 196, 0 },
+};
+
+#ifdef PORT_XILINX
+#define ENERGY_PLATFORM "MicroBlaze"
+#elif defined(__x86_64__) || defined(__i386__)
+#define ENERGY_PLATFORM "x86"
+#elif defined(__aarch64__) || defined(__arm__)
+#define ENERGY_PLATFORM "ARM"
+#else
+#define ENERGY_PLATFORM "host"
+#endif
+
+enum { ENERGY_NONE, ENERGY_MODEL, ENERGY_RAPL };
+
+static int backend = ENERGY_NONE;
+static u64 model_mw;
+static u64 last_power_mw;
+static const char *algorithm_name = "";
+static char source[160];
+
+#ifndef PORT_XILINX
+
+static rapl_t rapl;
+
+// Package energy of the repeated hash less the idle baseline, divided by the number of calls
+static u64 rapl_per_hash_nj(energy_hash_fn hash, int variant, const u8 *data, size_t len) {
+    u64 min_ticks = port_timer_hz() / 1000 * ENERGY_MIN_MS;
+    u64 calls = 0;
+    uint64_t before, after;
+
+    if (rapl_read(&rapl, &before) != 0) return ENERGY_UNKNOWN;
+    port_timer_start();
+    do {
+        hash(variant, data, len);
+        calls++;
+    } while (port_timer_read() < min_ticks);
+    u64 ticks = port_timer_stop();
+    if (rapl_read(&rapl, &after) != 0) return ENERGY_UNKNOWN;
+
+    double seconds = (double)ticks / port_timer_hz();
+    double active_uj = rapl_active_uj(&rapl, before, after, seconds);
+    last_power_mw = (u64)(active_uj / seconds / 1000 + 0.5);
+    return (u64)(active_uj * 1000 / calls + 0.5);
+}
+
+#endif
+
+void energy_init(const char *algorithm) {
+    const char *origin = "ENERGY_MODEL_MW";
+    algorithm_name = algorithm;
+    model_mw = 0;
+#ifdef ENERGY_MODEL_MW
+    model_mw = ENERGY_MODEL_MW;
+#else
+    for (size_t i = 0; i < sizeof(models) / sizeof(models[0]); i++) {
+        if (strcmp(models[i].platform, ENERGY_PLATFORM) == 0 && strcmp(models[i].algorithm, algorithm) == 0) {
+            model_mw = models[i].power_mw;
+            origin = models[i].calibrated ? "calibrated" : "uncalibrated";
+        }
+    }
+#endif
+#ifndef PORT_XILINX
+    const char *env = getenv("ENERGY_MODEL_MW");
+    if (env && *env) {
+        model_mw = strtoull(env, NULL, 10);
+        origin = "ENERGY_MODEL_MW";
+    }
+
+    if (rapl_open(&rapl) == 0 && rapl_measure_idle(&rapl, RAPL_IDLE_MS) == 0) {
+        backend = ENERGY_RAPL;
+        snprintf(source, sizeof(source), "RAPL %s, idle %lu mW subtracted", rapl.zone,
+                 (unsigned long)(rapl.idle_mw + 0.5));
+        return;
+    }
+#endif
+    if (model_mw) {
+        backend = ENERGY_MODEL;
+        last_power_mw = model_mw;
+        sprintf(source, "model, %s on %s, %s", algorithm, ENERGY_PLATFORM, origin);
+    } else {
+        backend = ENERGY_NONE;
+        sprintf(source, "no RAPL access and no %s model for %s, set ENERGY_MODEL_MW", algorithm, ENERGY_PLATFORM);
+    }
+}
+
+const char *energy_source(void) {
+    return source;
+}
+
+u64 energy_per_hash_nj(energy_hash_fn hash, int variant, const u8 *data, size_t len, u64 ticks) {
+    switch (backend) {
+#ifndef PORT_XILINX
+        case ENERGY_RAPL:
+            return rapl_per_hash_nj(hash, variant, data, len);
+#endif
+        case ENERGY_MODEL: {
+            u64 ticks_per_us = port_timer_hz() / 1000000;
+            (void)hash;
+            return ticks_per_us ? model_mw * ticks / ticks_per_us : ENERGY_UNKNOWN; // mW x us = nJ
+        }
+        default:
+            return ENERGY_UNKNOWN;
+    }
+}
+
+u64 energy_power_mw(void) {
+    return last_power_mw;
+}
+
+u64 energy_per_byte_pj(u64 energy_nj, size_t len) {
+    if (energy_nj == ENERGY_UNKNOWN || len == 0) return ENERGY_UNKNOWN;
+    return energy_nj * 1000 / len;
+}
+
+void energy_print(u64 energy_nj, size_t len) {
+    u64 pj_per_byte = energy_per_byte_pj(energy_nj, len);
+    if (energy_nj == ENERGY_UNKNOWN) {
+        port_printf("Energy: not available (%s)\n\r", energy_source());
+    } else if (pj_per_byte == ENERGY_UNKNOWN) {
+        port_printf("Energy: %lu nJ per hash (%s, %lu mW)\n\r", (unsigned long)energy_nj,
+                    energy_source(), (unsigned long)energy_power_mw());
+    } else {
+        port_printf("Energy: %lu nJ per hash, %lu pJ/byte (%s, %lu mW)\n\r", (unsigned long)energy_nj,
+                    (unsigned long)pj_per_byte, energy_source(), (unsigned long)energy_power_mw());
+    }
+    if (backend == ENERGY_RAPL && energy_nj != ENERGY_UNKNOWN) {
+        // Calibration: this line, from a run on the target, is the models[] entry of energy.c
+        port_printf("Model entry: { \"%s\", \"%s\", %lu, 1 }\n\r", ENERGY_PLATFORM, algorithm_name,
+                    (unsigned long)energy_power_mw());
+    }
+}
@@ -0,0 +1,47 @@
+#ifndef ENERGY_H_
+#define ENERGY_H_
+
+#include "port.h"
+
+// Energy per hash, from the first backend that is available:
+// - RAPL (Linux hosts, rapl.c): the powercap energy counter of ENERGY_RAPL_ZONE (environment,
+//   default /sys/class/powercap/intel-rapl:0, the CPU package; energy_uj is readable by root
+//   only on recent kernels). The counter covers the whole package and ticks about once a
+//   millisecond, so the hash is repeated for ENERGY_MIN_MS. The idle power, measured once in
+//   energy_init(), is subtracted before the energy is divided by the number of calls.
+// - Model: the power of the algorithm on this platform above idle times the measured time,
+//   from the models[] table of energy.c or ENERGY_MODEL_MW (at compile time, or in the
+//   environment on a host). The report says whether the entry is calibrated.
+//
+// Calibration, per platform and algorithm:
+// - Host with RAPL: run performance test 2 (1 MB) as root; energy_print() adds a
+//   "Model entry: { ... }" line with the measured power above idle for the models[] table.
+// - MicroBlaze: read the board supply with a power meter once at the idle menu and once while
+//   BATCH_AUTORUN hashes 1 MB inputs (e.g. r=1001); the difference in mW is the entry.
+
+#define ENERGY_UNKNOWN (~(u64)0)
+
+#ifndef ENERGY_MIN_MS
+#define ENERGY_MIN_MS 100
+#endif
+
+typedef int (*energy_hash_fn)(int variant, const u8 *data, size_t len);
+
+// Picks the backend for the algorithm ("SHA-2", "SHA-3", "ASCON")
+void energy_init(const char *algorithm);
+const char *energy_source(void);
+
+// Nanojoules of one hash of len bytes that took ticks timer ticks, or ENERGY_UNKNOWN.
+// The RAPL backend runs hash() again for ENERGY_MIN_MS; the model only uses ticks.
+u64 energy_per_hash_nj(energy_hash_fn hash, int variant, const u8 *data, size_t len, u64 ticks);
+
+// Average power of the last RAPL measurement, or the model power, in mW (0 if neither)
+u64 energy_power_mw(void);
+
+// Picojoules per byte, ENERGY_UNKNOWN for unknown energy or no bytes
+u64 energy_per_byte_pj(u64 energy_nj, size_t len);
+
+// "Energy: ... nJ per hash, ... pJ/byte (source)" line of the test reports
+void energy_print(u64 energy_nj, size_t len);
+
+#endif
@@ -90,6 +90,11 @@ void sha512_update(sha512_ctx *ctx, const uint8 *message, uint64 len);
 void sha512_final(sha512_ctx *ctx, uint8 *digest);
 void sha512(const uint8 *message, uint64 len, uint8 *digest);
 
+/* Initial hash values and round constants, exported so their size can be
+ * reported. */
+extern const uint32 sha224_h0[8], sha256_h0[8], sha256_k[64];
+extern const uint64 sha384_h0[8], sha512_h0[8], sha512_k[80];
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,43 @@
+#ifndef BATCH_H_
+#define BATCH_H_
+
+#include "port.h"
+
+// Unattended benchmark matrix: every variant x every size, repeated, with min/median/max
+// timer ticks (less port_timer_overhead()) and the energy (energy.h) per cell printed as CSV.
+// A spec is one line of space separated fields
+//   v=1-4 s=0,64,1k,1m r=11
+// v: variant numbers of the driver menu (lists and ranges), s: message sizes in bytes
+// (k and m suffixes), r: repetitions per cell. Missing fields come from BATCH_DEFAULT_SPEC.
+
+#ifndef BATCH_DEFAULT_SPEC
+#define BATCH_DEFAULT_SPEC "v=1-4 s=0,64,1k,16k,1m r=11"
+#endif
+
+#define BATCH_MAX_VARIANTS 8
+#define BATCH_MAX_SIZES 16
+#define BATCH_MAX_REPS 1001
+#define BATCH_MAX_SPEC 128
+
+typedef struct {
+    int variants[BATCH_MAX_VARIANTS];
+    int num_variants;
+    size_t sizes[BATCH_MAX_SIZES];
+    int num_sizes;
+    int reps;
+} batch_spec;
+
+// Hashes len bytes with the given variant, 0 on success; called once untimed (a cell whose
+// first call fails is skipped), then reps times timed
+typedef int (*batch_hash_fn)(int variant, const u8 *data, size_t len);
+
+// 0, or -1 after printing what is wrong with the spec. Variants must be 1..num_variants.
+int batch_parse(batch_spec *spec, const char *text, int num_variants);
+
+// Reads a spec line from the console with echo; an empty line gives BATCH_DEFAULT_SPEC
+void batch_read_spec(char *text, int size);
+
+// Runs the matrix; names[v - 1] is the name of variant v. 0, or -1 if out of memory.
+int batch_run(const batch_spec *spec, const char *const *names, batch_hash_fn hash);
+
+#endif
@@ -1,212 +1,304 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#include "platform.h"
-#include "xil_printf.h"
-#include "xparameters.h"
-#include "xtmrctr.h"
+#include "port.h"
+#include "batch.h"
+#include "energy.h"
 #include "sha3.h"  // Include the provided SHA-3 implementation headers
 
-#define TIMER_DEVICE_ID XPAR_TMRCTR_0_DEVICE_ID
 #define MAX_INPUT_SIZE 256
-#define CLOCK_FREQUENCY 100000000 // 100 MHz in Hz
-#define DYNAMIC_POWER_MW 196      // Power in milliwatts
+#define LATENCY_MAX_BYTES 136     // One SHA3-256 rate block
+#define LATENCY_SAMPLES 101       // Samples per message length
 
-XTmrCtr TimerInstance;
+static const char *const variant_names[] = { "SHA3-224", "SHA3-256", "SHA3-384", "SHA3-512" };
 
-void init_timer() {
-    int status = XTmrCtr_Initialize(&TimerInstance, TIMER_DEVICE_ID);
-    if (status != XST_SUCCESS) {
-        xil_printf("Timer Initialization Failed!\n\r");
-        while (1);
-    }
-    XTmrCtr_SetOptions(&TimerInstance, 0, XTC_AUTO_RELOAD_OPTION);
+// Context and constant tables of sha3.c (round constants, rotations, lane permutation)
+static const size_t context_size = sizeof(sha3_context);
+static const size_t table_size = sizeof(keccakf_rndc) + sizeof(keccakf_rotc) + sizeof(keccakf_piln);
+
+// Cycles of each step of one hash; report is reading the stack mark, formatting and printing the digest
+typedef struct {
+    u64 init;
+    u64 update;
+    u64 final;
+    u64 report;
+} phase_cycles;
+
+static u64 phase_ticks(u64 from, u64 to) {
+    u64 ticks = to - from;
+    return ticks > port_timer_overhead() ? ticks - port_timer_overhead() : 0;
 }
 
-void compute_sha3(const char *input_data, int mode) {
-    uint8_t digest[64]; // SHA3-512 uses 64 bytes
-    memset(digest, 0, sizeof(digest));
-    char hash_hex[2 * sizeof(digest) + 1];
+// Hashes and prints the digest, timing every phase and measuring the stack of sha3_Init/Update/Finalize
+// below this frame (ctx is not part of it); -1 if the mode is not supported
+int compute_sha3(const char *input_data, size_t input_size, int mode, phase_cycles *cycles, size_t *stack_bytes) {
+    static const unsigned bit_sizes[] = { 224, 256, 384, 512 };
+    char hash_hex[2 * 64 + 1]; // SHA3-512 uses 64 bytes
     memset(hash_hex, 0, sizeof(hash_hex));
     sha3_context ctx;
 
-    switch (mode) {
-        case 1: { // SHA3-224
-            sha3_Init(&ctx, 224);
-            sha3_Update(&ctx, input_data, strlen(input_data));
-            const uint8_t *final = sha3_Finalize(&ctx);
-            for (int i = 0; i < 28; i++) {
-                sprintf(hash_hex + i * 2, "%02x", final[i]);
-            }
-            xil_printf("SHA3-224 Hash: %s\n\r", hash_hex);
-            break;
-        }
-        case 2: { // SHA3-256
-            sha3_Init(&ctx, 256);
-            sha3_Update(&ctx, input_data, strlen(input_data));
-            const uint8_t *final = sha3_Finalize(&ctx);
-            for (int i = 0; i < 32; i++) {
-                sprintf(hash_hex + i * 2, "%02x", final[i]);
-            }
-            xil_printf("SHA3-256 Hash: %s\n\r", hash_hex);
-            break;
-        }
-        case 3: { // SHA3-384
-            sha3_Init(&ctx, 384);
-            sha3_Update(&ctx, input_data, strlen(input_data));
-            const uint8_t *final = sha3_Finalize(&ctx);
-            for (int i = 0; i < 48; i++) {
-                sprintf(hash_hex + i * 2, "%02x", final[i]);
-            }
-            xil_printf("SHA3-384 Hash: %s\n\r", hash_hex);
-            break;
+    if (mode < 1 || mode > 4) {
+        port_printf("Invalid mode selected.\n\r");
+        return -1;
+    }
+
+    port_stack_paint();
+    port_timer_start();
+    u64 t0 = port_timer_read();
+    int status = sha3_Init(&ctx, bit_sizes[mode - 1]);
+    u64 t1 = port_timer_read();
+    if (status != SHA3_RETURN_OK) {
+        port_timer_stop();
+        port_printf("%s is not supported by sha3_Init.\n\r", variant_names[mode - 1]);
+        return -1;
+    }
+    sha3_Update(&ctx, input_data, input_size);
+    u64 t2 = port_timer_read();
+    const uint8_t *final = sha3_Finalize(&ctx);
+    u64 t3 = port_timer_read();
+    *stack_bytes = port_stack_used(); // before printing, counted in report
+    for (unsigned i = 0; i < bit_sizes[mode - 1] / 8; i++) {
+        sprintf(hash_hex + i * 2, "%02x", final[i]);
+    }
+    port_printf("%s Hash: %s\n\r", variant_names[mode - 1], hash_hex);
+    u64 t4 = port_timer_read();
+    port_timer_stop();
+
+    cycles->init = phase_ticks(t0, t1);
+    cycles->update = phase_ticks(t1, t2);
+    cycles->final = phase_ticks(t2, t3);
+    cycles->report = phase_ticks(t3, t4);
+    return 0;
+}
+
+static void sort_cycles(u32 *v, int n) {
+    for (int i = 1; i < n; i++) {
+        u32 x = v[i];
+        int j = i - 1;
+        while (j >= 0 && v[j] > x) {
+            v[j + 1] = v[j];
+            j--;
         }
-        case 4: { // SHA3-512
-            sha3_Init(&ctx, 512);
-            sha3_Update(&ctx, input_data, strlen(input_data));
-            const uint8_t *final = sha3_Finalize(&ctx);
-            for (int i = 0; i < 64; i++) {
-                sprintf(hash_hex + i * 2, "%02x", final[i]);
-            }
-            xil_printf("SHA3-512 Hash: %s\n\r", hash_hex);
-            break;
+        v[j + 1] = x;
+    }
+}
+
+// p50/p99 cycles of sha3_HashBuffer for every length 0..LATENCY_MAX_BYTES
+void run_latency_test(int sha_variant) {
+    static const unsigned bit_sizes[] = { 224, 256, 384, 512 };
+    unsigned bit_size = bit_sizes[sha_variant - 1];
+    u8 input[LATENCY_MAX_BYTES];
+    u8 digest[64];
+    u32 samples[LATENCY_SAMPLES];
+
+    memset(input, 'A', sizeof(input));
+    if (sha3_HashBuffer(bit_size, SHA3_FLAGS_NONE, input, 0, digest, sizeof(digest)) != SHA3_RETURN_OK) {
+        port_printf("SHA3-%d is not supported by sha3_HashBuffer.\n\r", bit_size);
+        return;
+    }
+
+    port_printf("Running Short-Message Latency Test (SHA3-%d, %d samples per length)\n\r",
+               bit_size, LATENCY_SAMPLES);
+    port_printf("bytes,p50_cycles,p99_cycles\n\r");
+    for (int len = 0; len <= LATENCY_MAX_BYTES; len++) {
+        for (int i = 0; i < LATENCY_SAMPLES; i++) {
+            port_timer_start();
+            sha3_HashBuffer(bit_size, SHA3_FLAGS_NONE, input, len, digest, bit_size / 8);
+            u64 ticks = port_timer_stop(); // less the cost of reading the timer, as in batch.c
+            samples[i] = (u32)(ticks > port_timer_overhead() ? ticks - port_timer_overhead() : 0);
         }
-        default:
-            xil_printf("Invalid mode selected.\n\r");
-            return;
+        sort_cycles(samples, LATENCY_SAMPLES);
+        port_printf("%d,%lu,%lu\n\r", len,
+                   (unsigned long)samples[LATENCY_SAMPLES / 2],
+                   (unsigned long)samples[(LATENCY_SAMPLES * 99) / 100]);
+    }
+}
+
+// Hash only, for the batch matrix
+int hash_sha3(int mode, const u8 *data, size_t len) {
+    static const unsigned bit_sizes[] = { 224, 256, 384, 512 };
+    static u8 digest[64];
+    if (mode < 1 || mode > 4) return -1;
+    return sha3_HashBuffer(bit_sizes[mode - 1], SHA3_FLAGS_NONE, data, len, digest, bit_sizes[mode - 1] / 8)
+           == SHA3_RETURN_OK ? 0 : -1;
+}
+
+// Reads a spec (Enter for BATCH_DEFAULT_SPEC) and runs the whole matrix
+void run_batch(void) {
+    char text[BATCH_MAX_SPEC];
+    batch_spec spec;
+
+    port_printf("Enter batch spec, e.g. %s (Enter for default):\n\r", BATCH_DEFAULT_SPEC);
+    batch_read_spec(text, sizeof(text));
+    if (batch_parse(&spec, text, 4) != 0) {
+        return;
     }
+    port_printf("# batch %s\n\r", text);
+    batch_run(&spec, variant_names, hash_sha3);
 }
 
 void run_test_case(int sha_variant, int test_type) {
     char *data;
     size_t data_size = 0;
 
+    port_heap_reset_peak();
     switch (test_type) {
         case 1: { // Functional Test
-            xil_printf("Enter the input data (max %d characters):\n\r", MAX_INPUT_SIZE - 1);
-            data = (char *)malloc(MAX_INPUT_SIZE);
+            port_printf("Enter the input data (max %d characters):\n\r", MAX_INPUT_SIZE - 1);
+            data = (char *)port_malloc(MAX_INPUT_SIZE);
             char c;
             int i = 0;
             while (i < MAX_INPUT_SIZE - 1) {
-                c = inbyte();
+                c = port_getc();
                 if (c == '\r' || c == '\n') {
                     data[i] = '\0';
                     break;
                 }
                 data[i++] = c;
-                outbyte(c);
+                port_putc(c);
             }
-            data_size = strlen(data);
-            xil_printf("\n\rRunning Functional Test:\n\r");
+            data[i] = '\0';
+            data_size = i;
+            port_printf("\n\rRunning Functional Test:\n\r");
             break;
         }
         case 2: { // Edge Case
-            data = (char *)malloc(1);
+            data = (char *)port_malloc(1);
             data[0] = '\0';
             data_size = 0;
-            xil_printf("Running Edge Case Test (Empty Input)\n\r");
+            port_printf("Running Edge Case Test (Empty Input)\n\r");
             break;
         }
         case 3: { // Performance Test
-            xil_printf("Choose Performance Test:\n\r");
-            xil_printf("1: 1 KB Input\n\r");
-            xil_printf("2: 1 MB Input\n\r");
+            port_printf("Choose Performance Test:\n\r");
+            port_printf("1: 1 KB Input\n\r");
+            port_printf("2: 1 MB Input\n\r");
 
-            char choice = inbyte();
-            outbyte(choice);
-            xil_printf("\n\r");
+            char choice = port_getc();
+            port_putc(choice);
+            port_printf("\n\r");
 
             if (choice == '1') {
                 data_size = 1024; // 1 KB
             } else if (choice == '2') {
                 data_size = 1024 * 1024; // 1 MB
             } else {
-                xil_printf("Invalid choice. Returning to main menu.\n\r");
+                port_printf("Invalid choice. Returning to main menu.\n\r");
                 return;
             }
 
-            data = (char *)malloc(data_size);
+            data = (char *)port_malloc(data_size);
             memset(data, 'A', data_size);
-            xil_printf("Running Performance Test(%lu bytes)\n\r", data_size);
+            port_printf("Running Performance Test(%lu bytes)\n\r", (unsigned long)data_size);
             break;
         }
         default:
-            xil_printf("Invalid test case.\n\r");
+            port_printf("Invalid test case.\n\r");
             return;
     }
 
-    // Measure execution time
-    XTmrCtr_Reset(&TimerInstance, 0);
-    XTmrCtr_Start(&TimerInstance, 0);
-
-    compute_sha3(data, sha_variant);
-
-    XTmrCtr_Stop(&TimerInstance, 0);
-    u64 elapsed_cycles = XTmrCtr_GetValue(&TimerInstance, 0);
+    // Measure execution time of the hash alone, without printing the digest
+    phase_cycles cycles;
+    size_t stack_bytes;
+    if (compute_sha3(data, data_size, sha_variant, &cycles, &stack_bytes) != 0) {
+        port_free(data);
+        return;
+    }
+    u64 elapsed_cycles = cycles.init + cycles.update + cycles.final;
 
-    u64 execution_time_us = (elapsed_cycles * 1000000) / CLOCK_FREQUENCY;
-    u64 throughput_bps = (data_size * 1000000) / execution_time_us;
-    u64 energy_consumed_uj = (DYNAMIC_POWER_MW * execution_time_us) / 1000;
+    u64 execution_time_us = (elapsed_cycles * 1000000) / port_timer_hz();
+    u64 throughput_bps = elapsed_cycles ? ((u64)data_size * port_timer_hz()) / elapsed_cycles : 0;
+    u64 energy_nj = energy_per_hash_nj(hash_sha3, sha_variant, (const u8 *)data, data_size, elapsed_cycles);
 
-    xil_printf("Estimated Memory Usage: %lu bytes\n\r", data_size);
-    xil_printf("Elapsed Cycles: %lu\n\r", elapsed_cycles);
-    xil_printf("Execution Time: %lu microseconds\n\r", execution_time_us);
-    xil_printf("Throughput: %lu bytes/second\n\r", throughput_bps);
-    xil_printf("Estimated Energy Consumed: %lu microjoules\n\r", energy_consumed_uj);
+    port_printf("Stack Usage: %lu bytes%s in the hash calls, plus the %lu-byte context of the caller\n\r",
+                (unsigned long)stack_bytes, stack_bytes >= PORT_STACK_PAINT ? " or more" : "",
+                (unsigned long)context_size);
+    port_printf("Heap Usage: %lu bytes, the input buffer (the hash allocates nothing)\n\r",
+                (unsigned long)port_heap_peak());
+    port_printf("Static Tables: %lu bytes\n\r", (unsigned long)table_size);
+    port_printf("Phase Cycles: init %lu, update %lu, final %lu, report %lu\n\r",
+                (unsigned long)cycles.init, (unsigned long)cycles.update,
+                (unsigned long)cycles.final, (unsigned long)cycles.report);
+    port_printf("Elapsed Cycles: %lu\n\r", (unsigned long)elapsed_cycles);
+    port_printf("Execution Time: %lu microseconds\n\r", (unsigned long)execution_time_us);
+    port_printf("Throughput: %lu bytes/second\n\r", (unsigned long)throughput_bps);
+    energy_print(energy_nj, data_size);
 
-    free(data);
+    port_free(data);
 }
 
 int main() {
-    init_platform();
-    init_timer();
+    port_init();
+    port_printf("Timer: %s, %lu ticks per second\n\r", port_name(), (unsigned long)port_timer_hz());
+    energy_init("SHA-3");
+    port_printf("Energy: %s\n\r", energy_source());
+#ifdef BATCH_AUTORUN
+    // Unattended run of the compiled-in matrix, e.g. -DBATCH_AUTORUN -DBATCH_DEFAULT_SPEC='"v=2 s=1k,1m r=101"'
+    batch_spec spec;
+    if (batch_parse(&spec, "", 4) == 0) {
+        port_printf("# batch %s\n\r", BATCH_DEFAULT_SPEC);
+        batch_run(&spec, variant_names, hash_sha3);
+    }
+#endif
 
     while (1) {
-        xil_printf("\n\r=== SHA-3 Tests ===\n\r");
-        xil_printf("Select SHA Variant:\n\r");
-        xil_printf("1: SHA3-224\n\r");
-        xil_printf("2: SHA3-256\n\r");
-        xil_printf("3: SHA3-384\n\r");
-        xil_printf("4: SHA3-512\n\r");
-        xil_printf("0: Exit\n\r");
-
-        char variant_choice = inbyte();
-        outbyte(variant_choice);
-        xil_printf("\n\r");
+        port_printf("\n\r=== SHA-3 Tests ===\n\r");
+        port_printf("Select SHA Variant:\n\r");
+        port_printf("1: SHA3-224\n\r");
+        port_printf("2: SHA3-256\n\r");
+        port_printf("3: SHA3-384\n\r");
+        port_printf("4: SHA3-512\n\r");
+        port_printf("B: Batch Matrix\n\r");
+        port_printf("0: Exit\n\r");
+
+        char variant_choice = port_getc();
+        port_putc(variant_choice);
+        port_printf("\n\r");
+
+        if (variant_choice == 'B' || variant_choice == 'b') {
+            run_batch();
+            continue;
+        }
 
         int sha_variant = variant_choice - '0';
         if (sha_variant == 0) {
-            xil_printf("Exiting program. Goodbye!\n\r");
+            port_printf("Exiting program. Goodbye!\n\r");
             break;
         }
         if (sha_variant < 1 || sha_variant > 4) {
-            xil_printf("Invalid choice. Try again.\n\r");
+            port_printf("Invalid choice. Try again.\n\r");
             continue;
         }
 
-        xil_printf("Select Test Type:\n\r");
-        xil_printf("1: Functional Test\n\r");
-        xil_printf("2: Edge Case Test (Empty Input)\n\r");
-        xil_printf("3: Performance Test\n\r");
-        xil_printf("0: Return to Main Menu\n\r");
+        port_printf("Select Test Type:\n\r");
+        port_printf("1: Functional Test\n\r");
+        port_printf("2: Edge Case Test (Empty Input)\n\r");
+        port_printf("3: Performance Test\n\r");
+        port_printf("4: Short-Message Latency Test (0-%d bytes)\n\r", LATENCY_MAX_BYTES);
+        port_printf("0: Return to Main Menu\n\r");
 
-        char test_choice = inbyte();
-        outbyte(test_choice);
-        xil_printf("\n\r");
+        char test_choice = port_getc();
+        port_putc(test_choice);
+        port_printf("\n\r");
 
         int test_type = test_choice - '0';
         if (test_type == 0) {
-            xil_printf("Returning to main menu.\n\r");
+            port_printf("Returning to main menu.\n\r");
             continue;
         }
-        if (test_type < 1 || test_type > 3) {
-            xil_printf("Invalid choice. Try again.\n\r");
+        if (test_type < 1 || test_type > 4) {
+            port_printf("Invalid choice. Try again.\n\r");
+            continue;
+        }
+
+        if (test_type == 4) {
+            run_latency_test(sha_variant);
             continue;
         }
 
         run_test_case(sha_variant, test_type);
     }
 
-    cleanup_platform();
+    port_cleanup();
     return 0;
 }
@@ -0,0 +1,251 @@
+#include <stdlib.h>
+#include "port.h"
+
+static u64 timer_overhead;
+static void measure_overhead(void);
+
+#ifdef PORT_XILINX
+
+#include "platform.h"
+#include "xparameters.h"
+#include "xtmrctr.h"
+
+#define TIMER_DEVICE_ID XPAR_TMRCTR_0_DEVICE_ID
+#ifdef XPAR_TMRCTR_0_CLOCK_FREQ_HZ
+#define TIMER_FREQUENCY XPAR_TMRCTR_0_CLOCK_FREQ_HZ
+#else
+#define TIMER_FREQUENCY 100000000 // 100 MHz in Hz
+#endif
+
+static XTmrCtr TimerInstance;
+
+void port_init(void) {
+    init_platform();
+    int status = XTmrCtr_Initialize(&TimerInstance, TIMER_DEVICE_ID);
+    if (status != XST_SUCCESS) {
+        xil_printf("Timer Initialization Failed!\n\r");
+        while (1);
+    }
+    XTmrCtr_SetOptions(&TimerInstance, 0, XTC_AUTO_RELOAD_OPTION);
+    measure_overhead();
+}
+
+void port_cleanup(void) {
+    cleanup_platform();
+}
+
+const char *port_name(void) {
+    return "MicroBlaze AXI timer";
+}
+
+void port_timer_start(void) {
+    XTmrCtr_Reset(&TimerInstance, 0);
+    XTmrCtr_Start(&TimerInstance, 0);
+}
+
+u64 port_timer_stop(void) {
+    XTmrCtr_Stop(&TimerInstance, 0);
+    return XTmrCtr_GetValue(&TimerInstance, 0);
+}
+
+u64 port_timer_read(void) {
+    return XTmrCtr_GetValue(&TimerInstance, 0);
+}
+
+u64 port_timer_hz(void) {
+    return TIMER_FREQUENCY;
+}
+
+int port_getc(void) {
+    return inbyte();
+}
+
+void port_putc(int c) {
+    outbyte(c);
+}
+
+#else // Linux host
+
+#include <stdio.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define PORT_TSC
+#endif
+
+static u64 timer_hz = 1000000000;
+static u64 timer_start;
+static struct termios saved_termios;
+static int termios_changed = 0;
+
+static u64 port_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (u64)ts.tv_sec * 1000000000u + (u64)ts.tv_nsec;
+}
+
+static u64 port_ticks(void) {
+#ifdef PORT_TSC
+    return __rdtsc();
+#else
+    return port_ns();
+#endif
+}
+
+static void restore_terminal(void) {
+    if (termios_changed) {
+        tcsetattr(STDIN_FILENO, TCSANOW, &saved_termios);
+        termios_changed = 0;
+    }
+}
+
+void port_init(void) {
+#ifdef PORT_TSC
+    // TSC frequency against the monotonic clock over 20 ms
+    u64 ns = port_ns(), tsc = __rdtsc(), elapsed;
+    while ((elapsed = port_ns() - ns) < 20000000);
+    timer_hz = (__rdtsc() - tsc) * 1000000000u / elapsed;
+#endif
+    measure_overhead();
+    if (isatty(STDIN_FILENO) && tcgetattr(STDIN_FILENO, &saved_termios) == 0) {
+        struct termios raw = saved_termios;
+        raw.c_lflag &= ~(ICANON | ECHO);
+        raw.c_cc[VMIN] = 1;
+        raw.c_cc[VTIME] = 0;
+        if (tcsetattr(STDIN_FILENO, TCSANOW, &raw) == 0) {
+            termios_changed = 1;
+            atexit(restore_terminal);
+        }
+    }
+}
+
+void port_cleanup(void) {
+    fflush(stdout);
+    restore_terminal();
+}
+
+const char *port_name(void) {
+#ifdef PORT_TSC
+    return "x86 TSC";
+#else
+    return "clock_gettime";
+#endif
+}
+
+void port_timer_start(void) {
+    timer_start = port_ticks();
+}
+
+u64 port_timer_stop(void) {
+    return port_ticks() - timer_start;
+}
+
+u64 port_timer_read(void) {
+    return port_ticks() - timer_start;
+}
+
+u64 port_timer_hz(void) {
+    return timer_hz;
+}
+
+int port_getc(void) {
+    int c = getchar();
+    if (c == EOF) {
+        port_cleanup();
+        exit(0);
+    }
+    return c;
+}
+
+void port_putc(int c) {
+    putchar(c);
+    fflush(stdout);
+}
+
+#endif
+
+static void measure_overhead(void) {
+    u64 best = ~(u64)0;
+    port_timer_start();
+    for (int i = 0; i < 16; i++) {
+        u64 a = port_timer_read();
+        u64 b = port_timer_read();
+        if (b - a < best) best = b - a;
+    }
+    port_timer_stop();
+    timer_overhead = best;
+}
+
+u64 port_timer_overhead(void) {
+    return timer_overhead;
+}
+
+// Every block starts with its size, padded to keep malloc's alignment
+typedef union {
+    size_t size;
+    long double align_ld;
+    u64 align_u64;
+    void *align_ptr;
+} heap_header;
+
+static size_t heap_current, heap_peak;
+static unsigned long heap_allocations;
+
+void *port_malloc(size_t size) {
+    heap_header *h = (heap_header *)malloc(sizeof(heap_header) + size);
+    if (!h) return NULL;
+    h->size = size;
+    heap_current += size;
+    if (heap_current > heap_peak) heap_peak = heap_current;
+    heap_allocations++;
+    return h + 1;
+}
+
+void port_free(void *p) {
+    if (!p) return;
+    heap_header *h = (heap_header *)p - 1;
+    heap_current -= h->size;
+    free(h);
+}
+
+void port_heap_reset_peak(void) {
+    heap_peak = heap_current;
+    heap_allocations = 0;
+}
+
+size_t port_heap_current(void) {
+    return heap_current;
+}
+
+size_t port_heap_peak(void) {
+    return heap_peak;
+}
+
+unsigned long port_heap_allocations(void) {
+    return heap_allocations;
+}
+
+#define STACK_PATTERN 0xA5
+
+static uintptr_t stack_area; // lowest painted byte
+
+__attribute__((noinline)) void port_stack_paint(void) {
+    volatile u8 area[PORT_STACK_PAINT];
+    for (size_t i = 0; i < sizeof(area); i++) {
+        area[i] = STACK_PATTERN;
+    }
+    stack_area = (uintptr_t)area;
+}
+
+// Reads the stack below its own frame, which is free again after the painted calls returned
+__attribute__((noinline)) size_t port_stack_used(void) {
+    volatile const u8 *area = (volatile const u8 *)stack_area;
+    size_t i = 0;
+    while (i < PORT_STACK_PAINT && area[i] == STACK_PATTERN) {
+        i++;
+    }
+    return PORT_STACK_PAINT - i;
+}
@@ -0,0 +1,72 @@
+#ifndef PORT_H_
+#define PORT_H_
+
+// Platform layer of the benchmark drivers: cycle timer, console and memory.
+//
+// Xilinx backend (MicroBlaze, selected by __MICROBLAZE__ or -DPORT_XILINX): AXI timer 0,
+// inbyte/outbyte and xil_printf, exactly what the drivers used before.
+// Host backend (Linux on x86 or ARM): rdtsc on x86, clock_gettime elsewhere, and stdio.
+// The same driver builds on a PC or a Raspberry Pi without the platform files:
+//   gcc -O2 main_sha3.c sha3.c port.c batch.c energy.c rapl.c -o main_sha3
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__MICROBLAZE__) && !defined(PORT_XILINX)
+#define PORT_XILINX
+#endif
+
+#ifdef PORT_XILINX
+#include "xil_types.h"
+#include "xil_printf.h"
+#define port_printf xil_printf
+#else
+#include <stdio.h>
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+#define port_printf printf
+#endif
+
+void port_init(void);     // platform, timer and console; stops the program if the timer fails
+void port_cleanup(void);
+const char *port_name(void);  // timer description for the reports
+
+// Timer ticks between port_timer_start() and port_timer_stop(). On MicroBlaze a tick is one
+// clock cycle of the 32-bit AXI timer (wraps after 42 s at 100 MHz), on x86 one TSC cycle and
+// on other hosts one nanosecond.
+void port_timer_start(void);
+u64 port_timer_stop(void);
+u64 port_timer_hz(void);  // ticks per second
+
+// Ticks since port_timer_start() without stopping the timer, for several phases in one run.
+// A read costs port_timer_overhead() ticks (the cheapest of back-to-back reads at init).
+u64 port_timer_read(void);
+u64 port_timer_overhead(void);
+
+// Blocking read of one character. Host terminals are switched to unbuffered input without
+// echo so the menus behave like the UART; at the end of piped input the program exits.
+int port_getc(void);
+void port_putc(int c);
+
+// malloc/free with accounting: bytes in use, the peak since port_heap_reset_peak() and the
+// number of allocations since then
+void *port_malloc(size_t size);
+void port_free(void *p);
+void port_heap_reset_peak(void);
+size_t port_heap_current(void);
+size_t port_heap_peak(void);
+unsigned long port_heap_allocations(void);
+
+// Stack high-water mark. port_stack_paint() fills PORT_STACK_PAINT bytes of free stack below
+// the caller with a pattern; port_stack_used() called from the same function afterwards gives
+// how deep the calls in between wrote into it (PORT_STACK_PAINT means at least that much).
+// Accurate to the few bytes of the two frames; the MicroBlaze stack must be larger.
+#ifndef PORT_STACK_PAINT
+#define PORT_STACK_PAINT 16384
+#endif
+void port_stack_paint(void);
+size_t port_stack_used(void);
+
+#endif
@@ -0,0 +1,93 @@
+#ifdef __linux__
+#define _POSIX_C_SOURCE 200809L /* clock_gettime, nanosleep */
+#endif
+
+#include "rapl.h"
+
+#ifdef __linux__
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* one number of a file of the zone */
+static int rapl_file(const rapl_t* r, const char* name, uint64_t* value) {
+  char path[128];
+  unsigned long long v;
+  FILE* f;
+  int ok;
+  snprintf(path, sizeof(path), "%s/%s", r->zone, name);
+  f = fopen(path, "r");
+  if (!f) return -1;
+  ok = fscanf(f, "%llu", &v) == 1;
+  fclose(f);
+  if (!ok) return -1;
+  *value = v;
+  return 0;
+}
+
+static double rapl_seconds(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+int rapl_open(rapl_t* r) {
+  const char* zone = getenv("ENERGY_RAPL_ZONE");
+  uint64_t energy;
+  snprintf(r->zone, sizeof(r->zone), "%s",
+           zone && *zone ? zone : "/sys/class/powercap/intel-rapl:0");
+  r->idle_mw = 0;
+  if (rapl_file(r, "energy_uj", &energy)) return -1;
+  if (rapl_file(r, "max_energy_range_uj", &r->range_uj)) r->range_uj = 0;
+  return 0;
+}
+
+int rapl_read(const rapl_t* r, uint64_t* uj) {
+  return rapl_file(r, "energy_uj", uj);
+}
+
+int rapl_measure_idle(rapl_t* r, unsigned ms) {
+  struct timespec pause;
+  uint64_t before, after;
+  double start, seconds;
+  pause.tv_sec = ms / 1000;
+  pause.tv_nsec = (long)(ms % 1000) * 1000000;
+  if (rapl_read(r, &before)) return -1;
+  start = rapl_seconds();
+  nanosleep(&pause, NULL);
+  seconds = rapl_seconds() - start;
+  if (rapl_read(r, &after) || seconds <= 0) return -1;
+  r->idle_mw = 0;
+  r->idle_mw = rapl_active_uj(r, before, after, seconds) / seconds / 1000;
+  return 0;
+}
+
+#else
+
+int rapl_open(rapl_t* r) {
+  (void)r;
+  return -1;
+}
+
+int rapl_read(const rapl_t* r, uint64_t* uj) {
+  (void)r;
+  (void)uj;
+  return -1;
+}
+
+int rapl_measure_idle(rapl_t* r, unsigned ms) {
+  (void)r;
+  (void)ms;
+  return -1;
+}
+
+#endif
+
+double rapl_active_uj(const rapl_t* r, uint64_t before, uint64_t after,
+                      double seconds) {
+  double uj;
+  if (after < before) after += r->range_uj; /* wrapped */
+  uj = (double)(after - before) - r->idle_mw * seconds * 1000;
+  return uj > 0 ? uj : 0;
+}
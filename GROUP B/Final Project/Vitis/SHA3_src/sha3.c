@@ -44,7 +44,7 @@
 	(((x) << (y)) | ((x) >> ((sizeof(uint64_t)*8) - (y))))
 #endif
 
-static const uint64_t keccakf_rndc[24] = {
+const uint64_t keccakf_rndc[24] = {
     SHA3_CONST(0x0000000000000001UL), SHA3_CONST(0x0000000000008082UL),
     SHA3_CONST(0x800000000000808aUL), SHA3_CONST(0x8000000080008000UL),
     SHA3_CONST(0x000000000000808bUL), SHA3_CONST(0x0000000080000001UL),
@@ -59,12 +59,12 @@ static const uint64_t keccakf_rndc[24] = {
     SHA3_CONST(0x0000000080000001UL), SHA3_CONST(0x8000000080008008UL)
 };
 
-static const unsigned keccakf_rotc[24] = {
+const unsigned keccakf_rotc[24] = {
     1, 3, 6, 10, 15, 21, 28, 36, 45, 55, 2, 14, 27, 41, 56, 8, 25, 43, 62,
     18, 39, 61, 20, 44
 };
 
-static const unsigned keccakf_piln[24] = {
+const unsigned keccakf_piln[24] = {
     10, 7, 11, 17, 18, 3, 5, 16, 8, 21, 24, 4, 15, 23, 19, 13, 12, 2, 20,
     14, 22, 9, 6, 1
 };
@@ -115,6 +115,12 @@ keccakf(uint64_t s[25])
 
 /* *************************** Public Inteface ************************ */
 
+void
+sha3_Keccakf(uint64_t s[SHA3_KECCAK_SPONGE_WORDS])
+{
+    keccakf(s);
+}
+
 /* For Init or Reset call these: */
 sha3_return_t
 sha3_Init(void *priv, unsigned bitSize) {
@@ -303,10 +309,72 @@ sha3_Finalize(void *priv)
     return (ctx->u.sb);
 }
 
+/* One-shot hashing of a message that fits in a single rate block
+ * (inBytes < rate). The padded block is built directly in a bare state, so
+ * there is no context to clear, no saved/byteIndex bookkeeping, and only
+ * the requested digest bytes are converted on the way out.
+ */
+static void
+sha3_HashOneBlock(unsigned rateWords, uint64_t suffix, const uint8_t *buf,
+        unsigned inBytes, uint8_t *out, unsigned outBytes)
+{
+    uint64_t s[SHA3_KECCAK_SPONGE_WORDS];
+    unsigned words = inBytes / sizeof(uint64_t);
+    unsigned tail = inBytes - words * sizeof(uint64_t);
+    unsigned i;
+    uint64_t t = 0;
+
+    SHA3_ASSERT(words < rateWords);
+
+    for(i = 0; i < words; i++, buf += sizeof(uint64_t)) {
+        s[i] = (uint64_t) (buf[0]) |
+                ((uint64_t) (buf[1]) << 8 * 1) |
+                ((uint64_t) (buf[2]) << 8 * 2) |
+                ((uint64_t) (buf[3]) << 8 * 3) |
+                ((uint64_t) (buf[4]) << 8 * 4) |
+                ((uint64_t) (buf[5]) << 8 * 5) |
+                ((uint64_t) (buf[6]) << 8 * 6) |
+                ((uint64_t) (buf[7]) << 8 * 7);
+    }
+
+    /* last message bytes followed by the suffix, as in sha3_Finalize() */
+    for(i = 0; i < tail; i++)
+        t |= (uint64_t) buf[i] << (i * 8);
+    s[words] = t ^ (suffix << (tail * 8));
+
+    for(i = words + 1; i < SHA3_KECCAK_SPONGE_WORDS; i++)
+        s[i] = 0;
+    s[rateWords - 1] ^= SHA3_CONST(0x8000000000000000UL);
+
+    keccakf(s);
+
+    for(i = 0; i < outBytes; i++)
+        out[i] = (uint8_t) (s[i / 8] >> (8 * (i % 8)));
+}
+
 sha3_return_t sha3_HashBuffer( unsigned bitSize, enum SHA3_FLAGS flags, const void *in, unsigned inBytes, void *out, unsigned outBytes ) {
     sha3_return_t err;
     sha3_context c;
 
+    if( bitSize != 256 && bitSize != 384 && bitSize != 512 )
+        return SHA3_RETURN_BAD_PARAMS;
+    if( (flags & SHA3_FLAGS_KECCAK) != flags )
+        return SHA3_RETURN_BAD_PARAMS;
+
+    /* short messages: a single permutation, see sha3_HashOneBlock() */
+    {
+        const unsigned rateWords = SHA3_KECCAK_SPONGE_WORDS -
+                2 * bitSize / (8 * sizeof(uint64_t));
+        if( inBytes < rateWords * sizeof(uint64_t) ) {
+            if(outBytes > bitSize/8)
+                outBytes = bitSize/8;
+            sha3_HashOneBlock(rateWords,
+                    flags == SHA3_FLAGS_KECCAK ? 0x01 : (0x02 | (1 << 2)),
+                    in, inBytes, out, outBytes);
+            return SHA3_RETURN_OK;
+        }
+    }
+
     err = sha3_Init(&c, bitSize);
     if( err != SHA3_RETURN_OK )
         return err;
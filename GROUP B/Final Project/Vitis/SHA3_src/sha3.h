@@ -1,6 +1,7 @@
 #ifndef SHA3_H
 #define SHA3_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 /* -------------------------------------------------------------------------
@@ -50,6 +51,10 @@ enum SHA3_RETURN {
 };
 typedef enum SHA3_RETURN sha3_return_t;
 
+#ifdef __cplusplus
+extern "C" {
+#endif
+
 /* For Init or Reset call these: */
 sha3_return_t sha3_Init(void *priv, unsigned bitSize);
 
@@ -70,4 +75,18 @@ sha3_return_t sha3_HashBuffer(
     const void *in, unsigned inBytes,
     void *out, unsigned outBytes );     /* up to bitSize/8; truncation OK */
 
+/* The raw Keccak-f[1600] permutation, for callers (e.g. sha3.hpp) that
+ * drive the sponge themselves. */
+void sha3_Keccakf(uint64_t s[SHA3_KECCAK_SPONGE_WORDS]);
+
+/* Constant tables of the permutation (round constants, rotation offsets,
+ * lane order of the pi step), exported so their size can be reported. */
+extern const uint64_t keccakf_rndc[24];
+extern const unsigned keccakf_rotc[24];
+extern const unsigned keccakf_piln[24];
+
+#ifdef __cplusplus
+}
+#endif
+
 #endif
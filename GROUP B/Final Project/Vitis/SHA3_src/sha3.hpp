@@ -0,0 +1,239 @@
+#ifndef SHA3_HPP
+#define SHA3_HPP
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "sha3.h"
+
+/* -------------------------------------------------------------------------
+ * Compile-time specialized front end for the SHA-3 code in sha3.c.
+ *
+ * The C API keeps the rate and the padding mode in sha3_context, so
+ * sha3_Update() has to mask capacityWords with SHA3_CW() for every word it
+ * absorbs. Here the capacity and the domain separation suffix are template
+ * parameters, which lets the compiler unroll the absorb loop for the rate.
+ *
+ *   sha3<224|256|384|512>   FIPS 202 hashes           (suffix 01)
+ *   keccak<224|256|384|512> original Keccak padding   (SHA3_FLAGS_KECCAK)
+ *   shake<128|256>          FIPS 202 XOFs             (suffix 1111)
+ *
+ * The state is an ordinary sha3_context, so existing callers can keep
+ * using sha3_Update()/sha3_Finalize() on context(), or wrap a context that
+ * was started with sha3_Init() in one of these classes. sha3_Finalize()
+ * only knows the SHA-3 and Keccak paddings; finish SHAKE on the C++ side.
+ * ---------------------------------------------------------------------- */
+
+namespace sha3_detail {
+
+/* endian-independent, folds into a single load on little-endian targets */
+static inline uint64_t load64(const uint8_t *p)
+{
+    return (uint64_t) (p[0]) |
+            ((uint64_t) (p[1]) << 8 * 1) |
+            ((uint64_t) (p[2]) << 8 * 2) |
+            ((uint64_t) (p[3]) << 8 * 3) |
+            ((uint64_t) (p[4]) << 8 * 4) |
+            ((uint64_t) (p[5]) << 8 * 5) |
+            ((uint64_t) (p[6]) << 8 * 6) |
+            ((uint64_t) (p[7]) << 8 * 7);
+}
+
+/* s[I..N) ^= block words; recursion is resolved at compile time */
+template <unsigned I, unsigned N>
+struct absorb_words {
+    static inline void run(uint64_t *s, const uint8_t *p)
+    {
+        s[I] ^= load64(p + 8 * I);
+        absorb_words<I + 1, N>::run(s, p);
+    }
+};
+
+template <unsigned N>
+struct absorb_words<N, N> {
+    static inline void run(uint64_t *, const uint8_t *) {}
+};
+
+} /* namespace sha3_detail */
+
+template <unsigned CapacityBits, uint8_t Suffix>
+class keccak_sponge {
+public:
+    static_assert(CapacityBits % 64 == 0 && CapacityBits < 1600,
+            "capacity must be a whole number of lanes");
+
+    enum {
+        rate_bytes = (1600 - CapacityBits) / 8,
+        rate_words = rate_bytes / 8
+    };
+
+    keccak_sponge() { reset(); }
+
+    /* Adopt a context, e.g. one that sha3_Init()/sha3_Update() started.
+     * Its capacity must match this specialization. */
+    explicit keccak_sponge(const sha3_context &c) : ctx_(c) {}
+
+    void reset()
+    {
+        memset(&ctx_, 0, sizeof(ctx_));
+        ctx_.capacityWords = SHA3_KECCAK_SPONGE_WORDS - rate_words;
+        if (Suffix == 0x01)
+            sha3_SetFlags(&ctx_, SHA3_FLAGS_KECCAK);
+    }
+
+    sha3_context &context() { return ctx_; }
+    const sha3_context &context() const { return ctx_; }
+
+    void update(const void *bufIn, size_t len)
+    {
+        const uint8_t *buf = (const uint8_t *) bufIn;
+
+        /* finish a block left open by an earlier (possibly C) update */
+        if (ctx_.wordIndex != 0 || ctx_.byteIndex != 0) {
+            size_t fill = rate_bytes - (ctx_.wordIndex * 8 + ctx_.byteIndex);
+            if (fill > len)
+                fill = len;
+            sha3_Update(&ctx_, buf, fill);
+            buf += fill;
+            len -= fill;
+        }
+
+        /* whole blocks straight from the input */
+        while (len >= rate_bytes) {
+            sha3_detail::absorb_words<0, rate_words>::run(ctx_.u.s, buf);
+            sha3_Keccakf(ctx_.u.s);
+            buf += rate_bytes;
+            len -= rate_bytes;
+        }
+
+        /* the C code keeps the partial word in saved/byteIndex */
+        if (len)
+            sha3_Update(&ctx_, buf, len);
+    }
+
+protected:
+    /* pad10*1 with the domain separation bits in front, as in
+     * sha3_Finalize() */
+    void pad()
+    {
+        ctx_.u.s[ctx_.wordIndex] ^= ctx_.saved ^
+                ((uint64_t) Suffix << (ctx_.byteIndex * 8));
+        ctx_.u.s[rate_words - 1] ^= UINT64_C(0x8000000000000000);
+        sha3_Keccakf(ctx_.u.s);
+    }
+
+    /* copy state bytes [off, off + len) out in little-endian order */
+    void extract(uint8_t *out, size_t off, size_t len) const
+    {
+        size_t i;
+        for (i = 0; i < len; i++, off++)
+            out[i] = (uint8_t) (ctx_.u.s[off / 8] >> (8 * (off % 8)));
+    }
+
+    sha3_context ctx_;
+};
+
+template <unsigned CapacityBits, uint8_t Suffix, unsigned DigestBits>
+class keccak_hash : public keccak_sponge<CapacityBits, Suffix> {
+    typedef keccak_sponge<CapacityBits, Suffix> base;
+
+public:
+    enum { digest_bytes = DigestBits / 8 };
+
+    keccak_hash() {}
+    explicit keccak_hash(const sha3_context &c) : base(c) {}
+
+    /* Same contract as sha3_Finalize(): the digest is at the start of the
+     * returned buffer, which lives inside the context. Only the digest
+     * words are converted to bytes. */
+    const uint8_t *finalize()
+    {
+        unsigned i;
+        uint8_t w[8];
+
+        this->pad();
+        for (i = 0; i < (digest_bytes + 7) / 8; i++) {
+            this->extract(w, i * 8, 8);
+            memcpy(this->ctx_.u.sb + i * 8, w, 8);
+        }
+        return this->ctx_.u.sb;
+    }
+
+    void finalize(uint8_t out[digest_bytes])
+    {
+        this->pad();
+        this->extract(out, 0, digest_bytes);
+    }
+
+    static void hash(const void *in, size_t len, uint8_t out[digest_bytes])
+    {
+        keccak_hash h;
+        h.update(in, len);
+        h.finalize(out);
+    }
+};
+
+template <unsigned CapacityBits, uint8_t Suffix>
+class keccak_xof : public keccak_sponge<CapacityBits, Suffix> {
+    typedef keccak_sponge<CapacityBits, Suffix> base;
+
+public:
+    keccak_xof() : pos_(0), squeezing_(false) {}
+    explicit keccak_xof(const sha3_context &c)
+        : base(c), pos_(0), squeezing_(false) {}
+
+    void reset()
+    {
+        base::reset();
+        pos_ = 0;
+        squeezing_ = false;
+    }
+
+    /* May be called repeatedly; the first call pads the input. */
+    void squeeze(void *bufOut, size_t len)
+    {
+        uint8_t *out = (uint8_t *) bufOut;
+
+        if (!squeezing_) {
+            this->pad();
+            squeezing_ = true;
+        }
+        while (len) {
+            size_t n;
+            if (pos_ == base::rate_bytes) {
+                sha3_Keccakf(this->ctx_.u.s);
+                pos_ = 0;
+            }
+            n = base::rate_bytes - pos_;
+            if (n > len)
+                n = len;
+            this->extract(out, pos_, n);
+            out += n;
+            pos_ += n;
+            len -= n;
+        }
+    }
+
+    static void hash(const void *in, size_t len, void *out, size_t outLen)
+    {
+        keccak_xof x;
+        x.update(in, len);
+        x.squeeze(out, outLen);
+    }
+
+private:
+    size_t pos_;
+    bool squeezing_;
+};
+
+template <unsigned Bits>
+using sha3 = keccak_hash<2 * Bits, 0x06, Bits>;
+
+template <unsigned Bits>
+using keccak = keccak_hash<2 * Bits, 0x01, Bits>;
+
+template <unsigned Bits>
+using shake = keccak_xof<2 * Bits, 0x1F>;
+
+#endif
@@ -0,0 +1,146 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+
+#include "sha3.hpp"
+
+#define MAX_MSG 300 // past two SHAKE128 blocks, every partial length of every rate
+#define TIMED_BYTES (64 * 1024 * 1024)
+
+// FNV-1a over the outputs, for the variants sha3.c has no reference for
+#define SHA3_224_CHECKSUM 0xb76a0c89u // hashlib sha3_224, lengths 0..MAX_MSG
+#define SHAKE128_CHECKSUM 0x8ee99a58u // hashlib shake_128, len + 1 output bytes
+#define SHAKE256_CHECKSUM 0xdc30be63u // hashlib shake_256, len + 1 output bytes
+
+static uint8_t msg[MAX_MSG];
+
+static uint32_t fnv(uint32_t checksum, const uint8_t* p, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        checksum = (checksum ^ p[i]) * 16777619u;
+    }
+    return checksum;
+}
+
+// Hash against sha3_HashBuffer for every length: the one-shot hash, the finalize() that returns
+// a pointer into the context, an update split into C++/C/C++ parts and a context started in C
+template <class H>
+int check_hash(const char* name, unsigned bits, enum SHA3_FLAGS flags) {
+    uint8_t expected[H::digest_bytes], actual[H::digest_bytes];
+    int failures = 0;
+
+    for (int len = 0; len <= MAX_MSG; len++) {
+        int a = len / 3, b = 2 * len / 3;
+        sha3_HashBuffer(bits, flags, msg, len, expected, sizeof(expected));
+
+        H::hash(msg, len, actual);
+        int differs = memcmp(actual, expected, sizeof(expected)) != 0;
+
+        H h;
+        h.update(msg, len);
+        differs |= memcmp(h.finalize(), expected, sizeof(expected)) != 0;
+
+        H mixed;
+        mixed.update(msg, a);
+        sha3_Update(&mixed.context(), msg + a, b - a);
+        mixed.update(msg + b, len - b);
+        mixed.finalize(actual);
+        differs |= memcmp(actual, expected, sizeof(expected)) != 0;
+
+        sha3_context c;
+        sha3_Init(&c, bits);
+        sha3_SetFlags(&c, flags);
+        sha3_Update(&c, msg, a);
+        H adopted(c);
+        adopted.update(msg + a, len - a);
+        adopted.finalize(actual);
+        differs |= memcmp(actual, expected, sizeof(expected)) != 0;
+
+        if (differs) {
+            printf("%s: output differs (length %d)\n", name, len);
+            failures++;
+        }
+    }
+    printf("%s: %d of %d cases differ from sha3_HashBuffer\n", name, failures, MAX_MSG + 1);
+    return failures;
+}
+
+// Digests of every length against a checksum of hashlib's; sha3_Init has no SHA3-224
+template <class H>
+int check_hash_checksum(const char* name, uint32_t expected) {
+    uint8_t out[H::digest_bytes];
+    uint32_t checksum = 2166136261u;
+
+    for (int len = 0; len <= MAX_MSG; len++) {
+        H::hash(msg, len, out);
+        checksum = fnv(checksum, out, sizeof(out));
+    }
+    printf("%s: checksum %08lx, expected %08lx\n", name, (unsigned long)checksum, (unsigned long)expected);
+    return checksum != expected;
+}
+
+// len + 1 output bytes for every length against hashlib, squeezed at once and in three pieces
+template <class X>
+int check_xof(const char* name, uint32_t expected) {
+    uint8_t out[MAX_MSG + 1], pieces[MAX_MSG + 1];
+    uint32_t checksum = 2166136261u;
+    int failures = 0;
+
+    for (int len = 0; len <= MAX_MSG; len++) {
+        size_t outlen = len + 1, a = outlen / 3, b = outlen / 2;
+        X::hash(msg, len, out, outlen);
+        checksum = fnv(checksum, out, outlen);
+
+        X x;
+        x.update(msg, len);
+        x.squeeze(pieces, a);
+        x.squeeze(pieces + a, b - a);
+        x.squeeze(pieces + b, outlen - b);
+        if (memcmp(pieces, out, outlen) != 0) {
+            printf("%s: squeezing in pieces differs (length %d)\n", name, len);
+            failures++;
+        }
+    }
+    printf("%s: checksum %08lx, expected %08lx\n", name, (unsigned long)checksum, (unsigned long)expected);
+    return failures + (checksum != expected);
+}
+
+double seconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main() {
+    int failures = 0;
+
+    for (int i = 0; i < MAX_MSG; i++) msg[i] = (uint8_t)(5 * i + 3);
+
+    printf("Checking sha3.hpp\n");
+    failures += check_hash<sha3<256> >("SHA3-256", 256, SHA3_FLAGS_NONE);
+    failures += check_hash<sha3<384> >("SHA3-384", 384, SHA3_FLAGS_NONE);
+    failures += check_hash<sha3<512> >("SHA3-512", 512, SHA3_FLAGS_NONE);
+    failures += check_hash<keccak<256> >("Keccak-256", 256, SHA3_FLAGS_KECCAK);
+    failures += check_hash<keccak<384> >("Keccak-384", 384, SHA3_FLAGS_KECCAK);
+    failures += check_hash<keccak<512> >("Keccak-512", 512, SHA3_FLAGS_KECCAK);
+    failures += check_hash_checksum<sha3<224> >("SHA3-224", SHA3_224_CHECKSUM);
+    failures += check_xof<shake<128> >("SHAKE128", SHAKE128_CHECKSUM);
+    failures += check_xof<shake<256> >("SHAKE256", SHAKE256_CHECKSUM);
+    printf(failures ? "FAILED\n" : "OK\n");
+
+    // Same 1 MB buffer through sha3_HashBuffer and the template
+    static uint8_t buf[1024 * 1024];
+    uint8_t digest[32];
+    double t = seconds();
+    for (int i = 0; i < TIMED_BYTES / (int)sizeof(buf); i++) {
+        sha3_HashBuffer(256, SHA3_FLAGS_NONE, buf, sizeof(buf), digest, sizeof(digest));
+    }
+    double c_ns = (seconds() - t) * 1e9 / TIMED_BYTES;
+    t = seconds();
+    for (int i = 0; i < TIMED_BYTES / (int)sizeof(buf); i++) {
+        sha3<256>::hash(buf, sizeof(buf), digest);
+    }
+    double hpp_ns = (seconds() - t) * 1e9 / TIMED_BYTES;
+    printf("\nSHA3-256 of 1 MB messages, ns per byte (sha3.c / sha3.hpp): %.2f / %.2f\n", c_ns, hpp_ns);
+    return failures ? 1 : 0;
+}
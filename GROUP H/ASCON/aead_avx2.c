@@ -0,0 +1,417 @@
+#include "aead_avx2.h"
+
+#include <string.h>
+
+#include "api.h"
+#include "ascon.h"
+#include "ascon_aead.h"
+#include "constants.h"
+#include "word.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ASCON_X4_AVX2 1
+#include <immintrin.h>
+#endif
+
+#define ASCON_X4_ENCRYPT 0
+#define ASCON_X4_DECRYPT 1
+#define ASCON_X4_ADATA 2
+
+/* scalar fallback: one lane with the ascon_aead.h phases */
+static void ascon_lane_scalar(ascon_lane_t* l, uint64_t K0, uint64_t K1,
+                              int rate, int mode) {
+  const uint64_t iv = rate == ASCON_128A_RATE ? ASCON_128A_IV : ASCON_128_IV;
+  ascon_state_t s;
+
+  if (mode == ASCON_X4_DECRYPT && l->inlen < CRYPTO_ABYTES) {
+    l->outlen = 0;
+    l->result = -1;
+    return;
+  }
+  ascon_initaead(&s, iv, K0, K1, l->npub);
+  ascon_adata(&s, l->ad, l->adlen, rate);
+  if (mode == ASCON_X4_ENCRYPT) {
+    ascon_encrypt(&s, l->out, l->in, l->inlen, rate);
+    ascon_final(&s, K0, K1, rate);
+    STOREBYTES(l->out + l->inlen, s.x[3], 8);
+    STOREBYTES(l->out + l->inlen + 8, s.x[4], 8);
+    l->outlen = l->inlen + CRYPTO_ABYTES;
+    l->result = 0;
+  } else {
+    l->outlen = l->inlen - CRYPTO_ABYTES;
+    ascon_decrypt(&s, l->out, l->in, l->outlen, rate);
+    ascon_final(&s, K0, K1, rate);
+    l->result = ascon_verify(l->in + l->outlen, &s);
+  }
+}
+
+#ifdef ASCON_X4_AVX2
+
+#define X4_TARGET __attribute__((target("avx2")))
+
+#define X4_ROR(x, n) \
+  _mm256_or_si256(_mm256_srli_epi64(x, n), _mm256_slli_epi64(x, 64 - (n)))
+
+/* ROUND() from round.h on four states, lane i of x[j] is word j of state i */
+static inline X4_TARGET void ROUND_X4(__m256i* x, uint8_t C) {
+  __m256i t0, t1, t2, t3, t4;
+  /* addition of round constant */
+  x[2] = _mm256_xor_si256(x[2], _mm256_set1_epi64x(C));
+  /* substitution layer */
+  x[0] = _mm256_xor_si256(x[0], x[4]);
+  x[4] = _mm256_xor_si256(x[4], x[3]);
+  x[2] = _mm256_xor_si256(x[2], x[1]);
+  /* start of keccak s-box */
+  t0 = _mm256_xor_si256(x[0], _mm256_andnot_si256(x[1], x[2]));
+  t1 = _mm256_xor_si256(x[1], _mm256_andnot_si256(x[2], x[3]));
+  t2 = _mm256_xor_si256(x[2], _mm256_andnot_si256(x[3], x[4]));
+  t3 = _mm256_xor_si256(x[3], _mm256_andnot_si256(x[4], x[0]));
+  t4 = _mm256_xor_si256(x[4], _mm256_andnot_si256(x[0], x[1]));
+  /* end of keccak s-box */
+  t1 = _mm256_xor_si256(t1, t0);
+  t0 = _mm256_xor_si256(t0, t4);
+  t3 = _mm256_xor_si256(t3, t2);
+  t2 = _mm256_xor_si256(t2, _mm256_set1_epi64x(-1));
+  /* linear diffusion layer */
+  x[0] = _mm256_xor_si256(t0, _mm256_xor_si256(X4_ROR(t0, 19), X4_ROR(t0, 28)));
+  x[1] = _mm256_xor_si256(t1, _mm256_xor_si256(X4_ROR(t1, 61), X4_ROR(t1, 39)));
+  x[2] = _mm256_xor_si256(t2, _mm256_xor_si256(X4_ROR(t2, 1), X4_ROR(t2, 6)));
+  x[3] = _mm256_xor_si256(t3, _mm256_xor_si256(X4_ROR(t3, 10), X4_ROR(t3, 17)));
+  x[4] = _mm256_xor_si256(t4, _mm256_xor_si256(X4_ROR(t4, 7), X4_ROR(t4, 41)));
+}
+
+static inline X4_TARGET void P12_X4(__m256i* x) {
+  ROUND_X4(x, 0xf0);
+  ROUND_X4(x, 0xe1);
+  ROUND_X4(x, 0xd2);
+  ROUND_X4(x, 0xc3);
+  ROUND_X4(x, 0xb4);
+  ROUND_X4(x, 0xa5);
+  ROUND_X4(x, 0x96);
+  ROUND_X4(x, 0x87);
+  ROUND_X4(x, 0x78);
+  ROUND_X4(x, 0x69);
+  ROUND_X4(x, 0x5a);
+  ROUND_X4(x, 0x4b);
+}
+
+static inline X4_TARGET void P8_X4(__m256i* x) {
+  ROUND_X4(x, 0xb4);
+  ROUND_X4(x, 0xa5);
+  ROUND_X4(x, 0x96);
+  ROUND_X4(x, 0x87);
+  ROUND_X4(x, 0x78);
+  ROUND_X4(x, 0x69);
+  ROUND_X4(x, 0x5a);
+  ROUND_X4(x, 0x4b);
+}
+
+static inline X4_TARGET void P6_X4(__m256i* x) {
+  ROUND_X4(x, 0x96);
+  ROUND_X4(x, 0x87);
+  ROUND_X4(x, 0x78);
+  ROUND_X4(x, 0x69);
+  ROUND_X4(x, 0x5a);
+  ROUND_X4(x, 0x4b);
+}
+
+/* mask of the first n bytes of a word, n = 0..8 */
+static inline uint64_t x4_bytemask(int n) {
+  return n >= 8 ? ~(uint64_t)0 : ~(~(uint64_t)0 >> (8 * n));
+}
+
+/* Word that has to be xored into state word S for n input bytes; writes the
+ * n output bytes. Decryption xors in the plaintext, which leaves exactly the
+ * ciphertext bytes in the state, like the scalar CLEARBYTES/OR step. */
+static inline uint64_t x4_word(int mode, uint64_t S, const uint8_t* in,
+                               uint8_t* out, int n, int pad) {
+  uint64_t v = LOADBYTES(in, n);
+  if (mode == ASCON_X4_ENCRYPT) {
+    STOREBYTES(out, S ^ v, n);
+  } else if (mode == ASCON_X4_DECRYPT) {
+    STOREBYTES(out, S ^ v, n);
+    v = (S ^ v) & x4_bytemask(n);
+  }
+  if (pad) v ^= PAD(n);
+  return v;
+}
+
+/* per-lane position in the AD and message block streams */
+typedef struct {
+  uint64_t nad; /* AD blocks including the padded one, 0 without AD */
+  uint64_t nm;  /* message blocks including the padded one */
+  const uint8_t* ad;
+  uint64_t adlen;
+  const uint8_t* in;
+  uint8_t* out;
+  uint64_t mlen;
+} ascon_x4_sched_t;
+
+/* Four big-endian words from in + off of every lane. The x86 loads are
+ * little-endian, the shuffle swaps the bytes of each word. */
+static inline X4_TARGET __m256i x4_load(const ascon_x4_sched_t* sc, int off) {
+  const __m256i bswap = _mm256_setr_epi8(
+      7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+      7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+  uint64_t a, b, c, d;
+  memcpy(&a, sc[0].in + off, 8);
+  memcpy(&b, sc[1].in + off, 8);
+  memcpy(&c, sc[2].in + off, 8);
+  memcpy(&d, sc[3].in + off, 8);
+  return _mm256_shuffle_epi8(_mm256_set_epi64x(d, c, b, a), bswap);
+}
+
+static inline X4_TARGET void x4_store(ascon_x4_sched_t* sc, int off,
+                                      __m256i v) {
+  const __m256i bswap = _mm256_setr_epi8(
+      7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8,
+      7, 6, 5, 4, 3, 2, 1, 0, 15, 14, 13, 12, 11, 10, 9, 8);
+  __attribute__((aligned(32))) uint64_t w[4];
+  _mm256_store_si256((__m256i*)w, _mm256_shuffle_epi8(v, bswap));
+  memcpy(sc[0].out + off, &w[0], 8);
+  memcpy(sc[1].out + off, &w[1], 8);
+  memcpy(sc[2].out + off, &w[2], 8);
+  memcpy(sc[3].out + off, &w[3], 8);
+}
+
+/* k full message blocks on all four lanes, no per-lane bookkeeping */
+static inline X4_TARGET void ascon_x4_bulk(__m256i* x, ascon_x4_sched_t* sc,
+                                           int rate, int mode, uint64_t k) {
+  uint64_t j;
+  int i;
+  for (j = 0; j < k; j++) {
+    __m256i d0 = x4_load(sc, 0);
+    if (mode == ASCON_X4_ENCRYPT) {
+      x[0] = _mm256_xor_si256(x[0], d0);
+      x4_store(sc, 0, x[0]);
+    } else {
+      x4_store(sc, 0, _mm256_xor_si256(x[0], d0));
+      x[0] = d0;
+    }
+    if (rate == ASCON_128A_RATE) {
+      __m256i d1 = x4_load(sc, 8);
+      if (mode == ASCON_X4_ENCRYPT) {
+        x[1] = _mm256_xor_si256(x[1], d1);
+        x4_store(sc, 8, x[1]);
+      } else {
+        x4_store(sc, 8, _mm256_xor_si256(x[1], d1));
+        x[1] = d1;
+      }
+      P8_X4(x);
+    } else {
+      P6_X4(x);
+    }
+    for (i = 0; i < ASCON_X4_LANES; i++) {
+      sc[i].in += rate;
+      sc[i].out += rate;
+      sc[i].mlen -= rate;
+    }
+  }
+}
+
+static X4_TARGET void ascon_x4_avx2(ascon_lane_t* lanes,
+                                     const uint64_t* K0s, const uint64_t* K1s,
+                                     int nlanes, int rate, int mode) {
+  __attribute__((aligned(32))) uint64_t K0[4] = {0}, K1[4] = {0};
+  __attribute__((aligned(32))) uint64_t w[5][4] = {{0}};
+  __attribute__((aligned(32))) uint64_t v0[4], v1[4], ds[4], pm[4];
+  ascon_x4_sched_t sc[ASCON_X4_LANES];
+  uint64_t steps = 0, t;
+  __m256i x[5];
+  int i;
+
+  for (i = 0; i < ASCON_X4_LANES; i++) {
+    sc[i].nad = sc[i].nm = 0;
+    if (i >= nlanes) continue;
+    K0[i] = K0s[i];
+    K1[i] = K1s[i];
+    w[3][i] = LOADBYTES(lanes[i].npub, 8);
+    w[4][i] = LOADBYTES(lanes[i].npub + 8, 8);
+    sc[i].ad = lanes[i].ad;
+    sc[i].adlen = lanes[i].adlen;
+    sc[i].in = lanes[i].in;
+    sc[i].out = lanes[i].out;
+    sc[i].mlen = lanes[i].inlen;
+    if (mode == ASCON_X4_DECRYPT) sc[i].mlen -= CRYPTO_ABYTES;
+    sc[i].nad = sc[i].adlen ? sc[i].adlen / rate + 1 : 0;
+    sc[i].nm = sc[i].mlen / rate + 1;
+    if (sc[i].nad + sc[i].nm > steps) steps = sc[i].nad + sc[i].nm;
+  }
+
+  /* initialize */
+  x[0] = _mm256_set1_epi64x(rate == ASCON_128A_RATE ? ASCON_128A_IV
+                                                    : ASCON_128_IV);
+  x[1] = _mm256_load_si256((const __m256i*)K0);
+  x[2] = _mm256_load_si256((const __m256i*)K1);
+  x[3] = _mm256_load_si256((const __m256i*)w[3]);
+  x[4] = _mm256_load_si256((const __m256i*)w[4]);
+  P12_X4(x);
+  x[3] = _mm256_xor_si256(x[3], _mm256_load_si256((const __m256i*)K0));
+  x[4] = _mm256_xor_si256(x[4], _mm256_load_si256((const __m256i*)K1));
+
+  /* associated data, domain separation and message, one block per step;
+   * a lane that ran out of blocks keeps its state until finalization */
+  for (t = 0; t < steps; t++) {
+    int any = 0;
+    if (nlanes == ASCON_X4_LANES) {
+      /* all lanes past domain separation: run their common full blocks */
+      uint64_t k = ~(uint64_t)0;
+      for (i = 0; i < ASCON_X4_LANES; i++) {
+        if (t <= sc[i].nad || t >= sc[i].nad + sc[i].nm) break;
+        if (sc[i].mlen / rate < k) k = sc[i].mlen / rate;
+      }
+      if (i == ASCON_X4_LANES && k > 0) {
+        ascon_x4_bulk(x, sc, rate, mode, k);
+        t += k - 1;
+        continue;
+      }
+    }
+    _mm256_store_si256((__m256i*)w[0], x[0]);
+    if (rate == ASCON_128A_RATE) _mm256_store_si256((__m256i*)w[1], x[1]);
+    for (i = 0; i < ASCON_X4_LANES; i++) {
+      ascon_x4_sched_t* l = &sc[i];
+      v0[i] = v1[i] = ds[i] = pm[i] = 0;
+      if (t >= l->nad + l->nm) continue;
+      if (t < l->nad) {
+        int last = t == l->nad - 1;
+        int n = last ? (int)l->adlen : rate;
+        if (!last || n >= 8) {
+          v0[i] = x4_word(ASCON_X4_ADATA, 0, l->ad, 0, 8, 0);
+          if (rate == ASCON_128A_RATE)
+            v1[i] = x4_word(ASCON_X4_ADATA, 0, l->ad + 8, 0, n - 8, last);
+        } else {
+          v0[i] = x4_word(ASCON_X4_ADATA, 0, l->ad, 0, n, 1);
+        }
+        l->ad += n;
+        l->adlen -= n;
+        pm[i] = ~(uint64_t)0;
+      } else {
+        int last = t == l->nad + l->nm - 1;
+        int n = last ? (int)l->mlen : rate;
+        if (t == l->nad) ds[i] = DSEP();
+        if (!last || n >= 8) {
+          v0[i] = x4_word(mode, w[0][i], l->in, l->out, 8, 0);
+          if (rate == ASCON_128A_RATE)
+            v1[i] = x4_word(mode, w[1][i], l->in + 8, l->out + 8, n - 8, last);
+        } else {
+          v0[i] = x4_word(mode, w[0][i], l->in, l->out, n, 1);
+        }
+        l->in += n;
+        l->out += n;
+        l->mlen -= n;
+        pm[i] = last ? 0 : ~(uint64_t)0;
+      }
+      any |= pm[i] != 0;
+    }
+    x[0] = _mm256_xor_si256(x[0], _mm256_load_si256((const __m256i*)v0));
+    if (rate == ASCON_128A_RATE)
+      x[1] = _mm256_xor_si256(x[1], _mm256_load_si256((const __m256i*)v1));
+    x[4] = _mm256_xor_si256(x[4], _mm256_load_si256((const __m256i*)ds));
+    if (any) {
+      __m256i y[5];
+      __m256i mask = _mm256_load_si256((const __m256i*)pm);
+      int j;
+      for (j = 0; j < 5; j++) y[j] = x[j];
+      if (rate == ASCON_128A_RATE)
+        P8_X4(y);
+      else
+        P6_X4(y);
+      for (j = 0; j < 5; j++) x[j] = _mm256_blendv_epi8(x[j], y[j], mask);
+    }
+  }
+
+  /* finalize */
+  if (rate == ASCON_128A_RATE) {
+    x[2] = _mm256_xor_si256(x[2], _mm256_load_si256((const __m256i*)K0));
+    x[3] = _mm256_xor_si256(x[3], _mm256_load_si256((const __m256i*)K1));
+  } else {
+    x[1] = _mm256_xor_si256(x[1], _mm256_load_si256((const __m256i*)K0));
+    x[2] = _mm256_xor_si256(x[2], _mm256_load_si256((const __m256i*)K1));
+  }
+  P12_X4(x);
+  x[3] = _mm256_xor_si256(x[3], _mm256_load_si256((const __m256i*)K0));
+  x[4] = _mm256_xor_si256(x[4], _mm256_load_si256((const __m256i*)K1));
+  _mm256_store_si256((__m256i*)w[3], x[3]);
+  _mm256_store_si256((__m256i*)w[4], x[4]);
+
+  /* get or verify tags */
+  for (i = 0; i < nlanes; i++) {
+    ascon_state_t s;
+    s.x[3] = w[3][i];
+    s.x[4] = w[4][i];
+    if (mode == ASCON_X4_ENCRYPT) {
+      lanes[i].outlen = lanes[i].inlen + CRYPTO_ABYTES;
+      STOREBYTES(lanes[i].out + lanes[i].inlen, s.x[3], 8);
+      STOREBYTES(lanes[i].out + lanes[i].inlen + 8, s.x[4], 8);
+      lanes[i].result = 0;
+    } else {
+      lanes[i].outlen = lanes[i].inlen - CRYPTO_ABYTES;
+      lanes[i].result = ascon_verify(lanes[i].in + lanes[i].outlen, &s);
+    }
+  }
+}
+
+int ascon_x4_avx2_supported(void) {
+  return __builtin_cpu_supports("avx2") ? 1 : 0;
+}
+
+#else
+
+int ascon_x4_avx2_supported(void) { return 0; }
+
+#endif /* ASCON_X4_AVX2 */
+
+static int ascon_x4(ascon_lane_t* lanes, const uint64_t* K0,
+                    const uint64_t* K1, int nlanes, int rate, int mode) {
+  int i, result = 0;
+  if (nlanes > ASCON_X4_LANES) return -1;
+#ifdef ASCON_X4_AVX2
+  /* a single lane is faster in scalar code than in 1/4 of the vectors */
+  if (nlanes > 1 && ascon_x4_avx2_supported()) {
+    /* a short ciphertext fails before touching the state */
+    for (i = 0; i < nlanes; i++)
+      if (mode == ASCON_X4_DECRYPT && lanes[i].inlen < CRYPTO_ABYTES) break;
+    if (i == nlanes) {
+      ascon_x4_avx2(lanes, K0, K1, nlanes, rate, mode);
+      for (i = 0; i < nlanes; i++) result |= lanes[i].result;
+      return result;
+    }
+  }
+#endif
+  for (i = 0; i < nlanes; i++) {
+    ascon_lane_scalar(&lanes[i], K0[i], K1[i], rate, mode);
+    result |= lanes[i].result;
+  }
+  return result;
+}
+
+/* key words of lanes[i].k, as ascon_aead.c loads them */
+static int ascon_x4_load(ascon_lane_t* lanes, int nlanes, int rate,
+                         int mode) {
+  uint64_t K0[ASCON_X4_LANES], K1[ASCON_X4_LANES];
+  int i;
+  if (nlanes > ASCON_X4_LANES) return -1;
+  for (i = 0; i < nlanes; i++) {
+    K0[i] = LOADBYTES(lanes[i].k, 8);
+    K1[i] = LOADBYTES(lanes[i].k + 8, 8);
+  }
+  return ascon_x4(lanes, K0, K1, nlanes, rate, mode);
+}
+
+int ascon_aead_encrypt_x4(ascon_lane_t* lanes, int nlanes, int rate) {
+  return ascon_x4_load(lanes, nlanes, rate, ASCON_X4_ENCRYPT);
+}
+
+int ascon_aead_decrypt_x4(ascon_lane_t* lanes, int nlanes, int rate) {
+  return ascon_x4_load(lanes, nlanes, rate, ASCON_X4_DECRYPT);
+}
+
+int ascon_aead_encrypt_x4_keys(ascon_lane_t* lanes, const uint64_t* K0,
+                               const uint64_t* K1, int nlanes, int rate) {
+  return ascon_x4(lanes, K0, K1, nlanes, rate, ASCON_X4_ENCRYPT);
+}
+
+int ascon_aead_decrypt_x4_keys(ascon_lane_t* lanes, const uint64_t* K0,
+                               const uint64_t* K1, int nlanes, int rate) {
+  return ascon_x4(lanes, K0, K1, nlanes, rate, ASCON_X4_DECRYPT);
+}
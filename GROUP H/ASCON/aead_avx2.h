@@ -0,0 +1,44 @@
+#ifndef AEAD_AVX2_H_
+#define AEAD_AVX2_H_
+
+#include <stdint.h>
+
+#define ASCON_X4_LANES 4
+
+/* One independent message of a 4-lane call. Every lane has its own key,
+ * nonce and lengths. For encryption in is the plaintext (inlen bytes) and
+ * out receives inlen + CRYPTO_ABYTES bytes of ciphertext and tag; for
+ * decryption in is ciphertext and tag and out receives the plaintext.
+ * out may be equal to in for in place operation. */
+typedef struct {
+  const unsigned char* k;
+  const unsigned char* npub;
+  const unsigned char* ad;
+  unsigned long long adlen;
+  const unsigned char* in;
+  unsigned long long inlen;
+  unsigned char* out;
+  unsigned long long outlen; /* set by the call */
+  int result;                /* set by the call, 0 or -1 like crypto_aead_* */
+} ascon_lane_t;
+
+/* 1 if the CPU runs the AVX2 engine, 0 if the calls fall back to the
+ * scalar code (same results, one lane at a time) */
+int ascon_x4_avx2_supported(void);
+
+/* Ascon-128 (rate ASCON_128_RATE) or Ascon-128a (rate ASCON_128A_RATE) on
+ * up to ASCON_X4_LANES messages in parallel. Output is byte-identical to
+ * crypto_aead_encrypt/ascon128a_aead_encrypt and the decrypt counterparts.
+ * Returns 0 if every lane succeeded, -1 otherwise (see lanes[i].result). */
+int ascon_aead_encrypt_x4(ascon_lane_t* lanes, int nlanes, int rate);
+int ascon_aead_decrypt_x4(ascon_lane_t* lanes, int nlanes, int rate);
+
+/* The same with the key words already loaded (K0[i], K1[i] for lane i, as
+ * LOADBYTES(k, 8) and LOADBYTES(k + 8, 8) give them); lanes[i].k is not
+ * read. For callers that keep a key for many messages, e.g. aead_batch.c. */
+int ascon_aead_encrypt_x4_keys(ascon_lane_t* lanes, const uint64_t* K0,
+                               const uint64_t* K1, int nlanes, int rate);
+int ascon_aead_decrypt_x4_keys(ascon_lane_t* lanes, const uint64_t* K0,
+                               const uint64_t* K1, int nlanes, int rate);
+
+#endif /* AEAD_AVX2_H_ */
@@ -0,0 +1,186 @@
+#include "aead_batch.h"
+
+#include <string.h>
+
+#include "aead_avx2.h"
+#include "ascon_aead.h"
+
+/* packets are sorted in windows, so no allocation is needed */
+#define BATCH_WINDOW 256
+/* length classes per variant: number of AD and message blocks, capped */
+#define BATCH_CLASSES 32
+#define BATCH_BUCKETS (3 * BATCH_CLASSES)
+
+#if defined(__GNUC__)
+#define PREFETCH(p) __builtin_prefetch(p)
+#else
+#define PREFETCH(p) ((void)(p))
+#endif
+
+int ascon_session_init(ascon_session_t* session, int variant,
+                       const unsigned char* k) {
+  memset(session, 0, sizeof(*session));
+  session->variant = variant;
+  if (variant == ASCON_AEAD_80PQ) {
+    session->rate = ASCON_128_RATE;
+    session->K0 = LOADBYTES(k, 4) >> 32;
+    session->K1 = LOADBYTES(k + 4, 8);
+    session->K2 = LOADBYTES(k + 12, 8);
+    return 0;
+  }
+  if (variant != ASCON_AEAD_128 && variant != ASCON_AEAD_128A) return -1;
+  session->rate = variant == ASCON_AEAD_128A ? ASCON_128A_RATE : ASCON_128_RATE;
+  session->K0 = LOADBYTES(k, 8);
+  session->K1 = LOADBYTES(k + 8, 8);
+  return 0;
+}
+
+/* one packet with the preloaded key */
+static void packet_scalar(ascon_packet_t* p, int decrypt) {
+  const ascon_session_t* se = p->session;
+  ascon_state_t s;
+  size_t mlen;
+
+  if (decrypt && p->inlen < CRYPTO_ABYTES) {
+    p->outlen = 0;
+    p->result = -1;
+    return;
+  }
+  mlen = decrypt ? p->inlen - CRYPTO_ABYTES : p->inlen;
+  if (se->variant == ASCON_AEAD_80PQ)
+    ascon80pq_initaead(&s, se->K0, se->K1, se->K2, p->npub);
+  else
+    ascon_initaead(&s, se->rate == ASCON_128A_RATE ? ASCON_128A_IV
+                                                   : ASCON_128_IV,
+                   se->K0, se->K1, p->npub);
+  ascon_adata(&s, p->ad, p->adlen, se->rate);
+  if (decrypt)
+    ascon_decrypt(&s, p->out, p->in, mlen, se->rate);
+  else
+    ascon_encrypt(&s, p->out, p->in, mlen, se->rate);
+  if (se->variant == ASCON_AEAD_80PQ)
+    ascon80pq_final(&s, se->K0, se->K1, se->K2);
+  else
+    ascon_final(&s, se->K0, se->K1, se->rate);
+  if (decrypt) {
+    p->outlen = mlen;
+    p->result = ascon_verify(p->in + mlen, &s);
+  } else {
+    STOREBYTES(p->out + mlen, s.x[3], 8);
+    STOREBYTES(p->out + mlen + 8, s.x[4], 8);
+    p->outlen = mlen + CRYPTO_ABYTES;
+    p->result = 0;
+  }
+}
+
+/* up to ASCON_X4_LANES packets of the same variant */
+static void packet_group(ascon_packet_t** g, int n, int decrypt) {
+  ascon_lane_t lanes[ASCON_X4_LANES];
+  uint64_t K0[ASCON_X4_LANES], K1[ASCON_X4_LANES];
+  int i;
+
+  if (n == 1 || g[0]->session->variant == ASCON_AEAD_80PQ) {
+    for (i = 0; i < n; i++) packet_scalar(g[i], decrypt);
+    return;
+  }
+  for (i = 0; i < n; i++) {
+    K0[i] = g[i]->session->K0;
+    K1[i] = g[i]->session->K1;
+    lanes[i].k = NULL;
+    lanes[i].npub = g[i]->npub;
+    lanes[i].ad = g[i]->ad;
+    lanes[i].adlen = g[i]->adlen;
+    lanes[i].in = g[i]->in;
+    lanes[i].inlen = g[i]->inlen;
+    lanes[i].out = g[i]->out;
+  }
+  if (decrypt)
+    ascon_aead_decrypt_x4_keys(lanes, K0, K1, n, g[0]->session->rate);
+  else
+    ascon_aead_encrypt_x4_keys(lanes, K0, K1, n, g[0]->session->rate);
+  for (i = 0; i < n; i++) {
+    g[i]->outlen = lanes[i].outlen;
+    g[i]->result = lanes[i].result;
+  }
+}
+
+/* -1 for a packet without a valid session (one ascon_session_init()
+ * rejected, or never initialized) */
+static int packet_bucket(const ascon_packet_t* p, int decrypt) {
+  const ascon_session_t* se = p->session;
+  size_t rate, mlen = p->inlen;
+  size_t blocks;
+  if (!se || se->variant < ASCON_AEAD_128 || se->variant > ASCON_AEAD_80PQ ||
+      se->rate != (se->variant == ASCON_AEAD_128A ? ASCON_128A_RATE
+                                                  : ASCON_128_RATE))
+    return -1;
+  rate = se->rate;
+  if (decrypt) mlen = mlen < CRYPTO_ABYTES ? 0 : mlen - CRYPTO_ABYTES;
+  blocks = p->adlen / rate + mlen / rate;
+  if (blocks >= BATCH_CLASSES) blocks = BATCH_CLASSES - 1;
+  return p->session->variant * BATCH_CLASSES + (int)blocks;
+}
+
+static void prefetch_packet(const ascon_packet_t* p) {
+  PREFETCH(p->npub);
+  PREFETCH(p->in);
+  if (p->adlen) PREFETCH(p->ad);
+}
+
+static size_t batch_window(ascon_packet_t* packets, size_t n, int decrypt) {
+  ascon_packet_t* order[BATCH_WINDOW];
+  int bucket[BATCH_WINDOW];
+  size_t start[BATCH_BUCKETS + 1];
+  size_t i, failed = 0;
+
+  /* counting sort by variant and length class; invalid packets fail here */
+  memset(start, 0, sizeof(start));
+  for (i = 0; i < n; i++) {
+    bucket[i] = packet_bucket(&packets[i], decrypt);
+    if (bucket[i] < 0) {
+      packets[i].outlen = 0;
+      packets[i].result = -1;
+      failed++;
+      continue;
+    }
+    start[bucket[i] + 1]++;
+  }
+  for (i = 0; i < BATCH_BUCKETS; i++) start[i + 1] += start[i];
+  for (i = 0; i < n; i++)
+    if (bucket[i] >= 0) order[start[bucket[i]]++] = &packets[i];
+  n -= failed;
+
+  /* groups never span two variants; the buckets are ordered by variant */
+  i = 0;
+  while (i < n) {
+    size_t j, end = i + 1;
+    while (end < n && end - i < ASCON_X4_LANES &&
+           order[end]->session->variant == order[i]->session->variant)
+      end++;
+    for (j = end; j < n && j < end + ASCON_X4_LANES; j++)
+      prefetch_packet(order[j]);
+    packet_group(order + i, (int)(end - i), decrypt);
+    for (j = i; j < end; j++) failed += order[j]->result != 0;
+    i = end;
+  }
+  return failed;
+}
+
+static size_t batch(ascon_packet_t* packets, size_t n, int decrypt) {
+  size_t failed = 0;
+  while (n) {
+    size_t w = n < BATCH_WINDOW ? n : BATCH_WINDOW;
+    failed += batch_window(packets, w, decrypt);
+    packets += w;
+    n -= w;
+  }
+  return failed;
+}
+
+size_t ascon_decrypt_batch(ascon_packet_t* packets, size_t n) {
+  return batch(packets, n, 1);
+}
+
+size_t ascon_encrypt_batch(ascon_packet_t* packets, size_t n) {
+  return batch(packets, n, 0);
+}
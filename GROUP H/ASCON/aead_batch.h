@@ -0,0 +1,45 @@
+#ifndef AEAD_BATCH_H_
+#define AEAD_BATCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "aead_stream.h"
+
+/* Key of one session, loaded once. variant is ASCON_AEAD_128,
+ * ASCON_AEAD_128A or ASCON_AEAD_80PQ from aead_stream.h. */
+typedef struct {
+  uint64_t K0, K1, K2;
+  int variant;
+  int rate;
+} ascon_session_t;
+
+/* One packet of a batch. For decryption in is ciphertext and tag and out
+ * receives inlen - CRYPTO_ABYTES bytes, for encryption out receives
+ * inlen + CRYPTO_ABYTES bytes. out may be equal to in. */
+typedef struct {
+  const ascon_session_t* session;
+  const unsigned char* npub;
+  const unsigned char* ad;
+  size_t adlen;
+  const unsigned char* in;
+  size_t inlen;
+  unsigned char* out;
+  size_t outlen; /* set by the call */
+  int result;    /* set by the call, 0 or -1 like crypto_aead_* */
+} ascon_packet_t;
+
+/* returns -1 for an unknown variant; packets of such a session fail in the
+ * batch calls (result -1) without being processed */
+int ascon_session_init(ascon_session_t* session, int variant,
+                       const unsigned char* k);
+
+/* Process n packets of any sessions and variants. Packets are reordered
+ * internally into groups of the same variant and a similar number of
+ * blocks, which run 4 at a time on the AVX2 engine (aead_avx2.c) while the
+ * next group is prefetched. Results are reported per packet; the return
+ * value is the number of packets that failed. */
+size_t ascon_decrypt_batch(ascon_packet_t* packets, size_t n);
+size_t ascon_encrypt_batch(ascon_packet_t* packets, size_t n);
+
+#endif /* AEAD_BATCH_H_ */
@@ -0,0 +1,433 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "aead_avx2.h"
+#include "aead_batch.h"
+#include "aead_stream.h"
+#include "api.h"
+#include "ascon_aead.h"
+
+#define MAX_MSG 80 // several blocks of both rates plus every partial length
+#define MAX_AD 40
+#define MAX_FRAGMENTS 8
+#define SENTINEL 0xa5
+#define BATCH_PACKETS 600 // more than one window of aead_batch.c
+
+typedef int (*Encrypt)(unsigned char*, unsigned long long*, const unsigned char*, unsigned long long,
+                       const unsigned char*, unsigned long long, const unsigned char*, const unsigned char*,
+                       const unsigned char*);
+typedef int (*Decrypt)(unsigned char*, unsigned long long*, unsigned char*, const unsigned char*,
+                       unsigned long long, const unsigned char*, unsigned long long, const unsigned char*,
+                       const unsigned char*);
+
+typedef struct {
+    const char* name;
+    int variant;
+    int rate;        // 0: no x4 entry point
+    Encrypt encrypt; // one-shot functions of ascon_aead.c
+    Decrypt decrypt;
+} Variant;
+
+static const Variant variants[] = {
+    { "Ascon-128", ASCON_AEAD_128, ASCON_128_RATE, ascon128_aead_encrypt, ascon128_aead_decrypt },
+    { "Ascon-128a", ASCON_AEAD_128A, ASCON_128A_RATE, ascon128a_aead_encrypt, ascon128a_aead_decrypt },
+    { "Ascon-80pq", ASCON_AEAD_80PQ, 0, ascon80pq_aead_encrypt, ascon80pq_aead_decrypt },
+};
+
+static uint8_t key[ASCON_80PQ_KEYBYTES], nonce[CRYPTO_NPUBBYTES], ad[MAX_AD], msg[MAX_MSG];
+static uint32_t lcg = 1;
+
+// Split points of the fragmented calls, the same on every platform
+static size_t next_split(size_t left) {
+    lcg = lcg * 1103515245u + 12345u;
+    return left ? (lcg >> 16) % (left + 1) : 0;
+}
+
+// Reference result, one update call each: ciphertext followed by the tag
+static void encrypt_once(int variant, size_t adlen, const uint8_t* m, size_t mlen, uint8_t* out) {
+    ascon_aead_ctx_t ctx;
+    ascon_aead_init(&ctx, variant, key, nonce);
+    ascon_aead_update_ad(&ctx, ad, adlen);
+    ascon_aead_encrypt_update(&ctx, out, m, mlen);
+    ascon_aead_encrypt_final(&ctx, out + mlen);
+}
+
+// Cuts len bytes at p into at most MAX_FRAGMENTS pieces (empty pieces included)
+static int fragment(uint8_t* p, size_t len, ascon_iovec_t* iov) {
+    int n = 0;
+    while (n < MAX_FRAGMENTS - 1 && len) {
+        size_t piece = next_split(len);
+        iov[n].base = p;
+        iov[n].len = piece;
+        p += piece;
+        len -= piece;
+        n++;
+    }
+    iov[n].base = p;
+    iov[n].len = len;
+    return n + 1;
+}
+
+// Update calls split at arbitrary points must give the result of a single call, also in place
+static int check_stream(const Variant* v, size_t adlen, size_t mlen, const uint8_t* expected) {
+    ascon_aead_ctx_t ctx;
+    uint8_t out[MAX_MSG + CRYPTO_ABYTES];
+    int failures = 0;
+
+    for (int in_place = 0; in_place <= 1; in_place++) {
+        const uint8_t* in = msg;
+        if (in_place) {
+            memcpy(out, msg, mlen);
+            in = out;
+        }
+        ascon_aead_init(&ctx, v->variant, key, nonce);
+        for (size_t done = 0, piece; done < adlen; done += piece) {
+            piece = next_split(adlen - done);
+            ascon_aead_update_ad(&ctx, ad + done, piece);
+        }
+        for (size_t done = 0, piece; done < mlen; done += piece) {
+            piece = next_split(mlen - done);
+            ascon_aead_encrypt_update(&ctx, out + done, in + done, piece);
+        }
+        ascon_aead_encrypt_final(&ctx, out + mlen);
+        if (memcmp(out, expected, mlen + CRYPTO_ABYTES) != 0) {
+            printf("%s: split encryption differs (adlen %d, mlen %d)\n", v->name, (int)adlen, (int)mlen);
+            failures++;
+        }
+
+        // decrypt in place, split differently
+        memcpy(out, expected, mlen + CRYPTO_ABYTES);
+        ascon_aead_init(&ctx, v->variant, key, nonce);
+        ascon_aead_update_ad(&ctx, ad, adlen);
+        for (size_t done = 0, piece; done < mlen; done += piece) {
+            piece = next_split(mlen - done);
+            ascon_aead_decrypt_update(&ctx, out + done, out + done, piece);
+        }
+        if (ascon_aead_decrypt_final(&ctx, out + mlen) != 0 || memcmp(out, msg, mlen) != 0) {
+            printf("%s: split decryption failed (adlen %d, mlen %d)\n", v->name, (int)adlen, (int)mlen);
+            failures++;
+        }
+    }
+
+    memcpy(out, expected, mlen + CRYPTO_ABYTES);
+    out[mlen + (adlen + mlen) % CRYPTO_ABYTES] ^= 0x80;
+    ascon_aead_init(&ctx, v->variant, key, nonce);
+    ascon_aead_update_ad(&ctx, ad, adlen);
+    ascon_aead_decrypt_update(&ctx, out, out, mlen);
+    if (ascon_aead_decrypt_final(&ctx, out + mlen) == 0) {
+        printf("%s: modified tag accepted by the stream (adlen %d, mlen %d)\n", v->name, (int)adlen, (int)mlen);
+        failures++;
+    }
+    return failures;
+}
+
+// The crypto_aead_* one-shot functions: separate buffers, c == m and tag rejection
+static int check_one_shot(const Variant* v, size_t adlen, size_t mlen, const uint8_t* expected) {
+    uint8_t out[MAX_MSG + CRYPTO_ABYTES], plain[MAX_MSG];
+    unsigned long long len;
+    int failures = 0;
+
+    v->encrypt(out, &len, msg, mlen, ad, adlen, NULL, nonce, key);
+    if (len != mlen + CRYPTO_ABYTES || memcmp(out, expected, len) != 0) {
+        printf("%s: one-shot encryption differs (adlen %d, mlen %d)\n", v->name, (int)adlen, (int)mlen);
+        failures++;
+    }
+    memcpy(out, msg, mlen);
+    v->encrypt(out, &len, out, mlen, ad, adlen, NULL, nonce, key);
+    if (memcmp(out, expected, mlen + CRYPTO_ABYTES) != 0) {
+        printf("%s: in-place one-shot encryption differs (adlen %d, mlen %d)\n", v->name, (int)adlen, (int)mlen);
+        failures++;
+    }
+    if (v->decrypt(plain, &len, NULL, expected, mlen + CRYPTO_ABYTES, ad, adlen, nonce, key) != 0 ||
+        len != mlen || memcmp(plain, msg, mlen) != 0) {
+        printf("%s: one-shot decryption failed (adlen %d, mlen %d)\n", v->name, (int)adlen, (int)mlen);
+        failures++;
+    }
+    if (v->decrypt(out, &len, NULL, out, mlen + CRYPTO_ABYTES, ad, adlen, nonce, key) != 0 ||
+        memcmp(out, msg, mlen) != 0) {
+        printf("%s: in-place one-shot decryption failed (adlen %d, mlen %d)\n", v->name, (int)adlen, (int)mlen);
+        failures++;
+    }
+    memcpy(out, expected, mlen + CRYPTO_ABYTES);
+    out[(adlen + mlen) % (mlen + CRYPTO_ABYTES)] ^= 0x01;
+    if (v->decrypt(plain, &len, NULL, out, mlen + CRYPTO_ABYTES, ad, adlen, nonce, key) == 0) {
+        printf("%s: modified ciphertext accepted by the one-shot call (adlen %d, mlen %d)\n", v->name,
+               (int)adlen, (int)mlen);
+        failures++;
+    }
+    return failures;
+}
+
+// Scatter-gather calls over random fragments, to separate buffers and in place, and the
+// error paths: a bad tag clears every output fragment, a length mismatch writes nothing
+static int check_iovec(const Variant* v, size_t adlen, size_t mlen, const uint8_t* expected) {
+    uint8_t adbuf[MAX_AD], in[MAX_MSG], out[MAX_MSG], tag[CRYPTO_ABYTES];
+    ascon_iovec_t adv[MAX_FRAGMENTS], inv[MAX_FRAGMENTS], outv[MAX_FRAGMENTS];
+    int failures = 0;
+
+    memcpy(adbuf, ad, adlen);
+    int adcnt = fragment(adbuf, adlen, adv);
+    int cnt = fragment(in, mlen, inv);
+    for (int i = 0; i < cnt; i++) {
+        outv[i].base = out + ((uint8_t*)inv[i].base - in);
+        outv[i].len = inv[i].len;
+    }
+
+    memcpy(in, msg, mlen);
+    if (ascon_aead_encryptv(v->variant, key, nonce, adv, adcnt, inv, outv, cnt, tag) != 0 ||
+        memcmp(out, expected, mlen) != 0 || memcmp(tag, expected + mlen, CRYPTO_ABYTES) != 0 ||
+        memcmp(in, msg, mlen) != 0) {
+        printf("%s: encryptv differs (adlen %d, mlen %d)\n", v->name, (int)adlen, (int)mlen);
+        failures++;
+    }
+    memset(in, 0, mlen);
+    if (ascon_aead_decryptv(v->variant, key, nonce, adv, adcnt, outv, inv, cnt, expected + mlen) != 0 ||
+        memcmp(in, msg, mlen) != 0) {
+        printf("%s: decryptv failed (adlen %d, mlen %d)\n", v->name, (int)adlen, (int)mlen);
+        failures++;
+    }
+
+    // in place: out == in
+    memcpy(in, msg, mlen);
+    if (ascon_aead_encryptv(v->variant, key, nonce, adv, adcnt, inv, inv, cnt, tag) != 0 ||
+        memcmp(in, expected, mlen) != 0 || memcmp(tag, expected + mlen, CRYPTO_ABYTES) != 0) {
+        printf("%s: in-place encryptv differs (adlen %d, mlen %d)\n", v->name, (int)adlen, (int)mlen);
+        failures++;
+    }
+    if (ascon_aead_decryptv(v->variant, key, nonce, adv, adcnt, inv, inv, cnt, tag) != 0 ||
+        memcmp(in, msg, mlen) != 0) {
+        printf("%s: in-place decryptv failed (adlen %d, mlen %d)\n", v->name, (int)adlen, (int)mlen);
+        failures++;
+    }
+
+    // bad tag: -1 and every output fragment cleared
+    memcpy(in, expected, mlen);
+    memset(out, SENTINEL, mlen);
+    tag[(adlen + mlen) % CRYPTO_ABYTES] ^= 0x01;
+    int wrong = ascon_aead_decryptv(v->variant, key, nonce, adv, adcnt, inv, outv, cnt, tag) != -1;
+    for (size_t i = 0; i < mlen; i++) wrong |= out[i] != 0;
+    if (wrong) {
+        printf("%s: decryptv with a bad tag did not fail or clear its output (adlen %d, mlen %d)\n", v->name,
+               (int)adlen, (int)mlen);
+        failures++;
+    }
+
+    // length mismatch: -1 before anything is written
+    if (cnt > 1) {
+        outv[cnt - 1].len++;
+        memset(out, SENTINEL, sizeof(out));
+        wrong = ascon_aead_encryptv(v->variant, key, nonce, adv, adcnt, inv, outv, cnt, tag) != -1;
+        wrong |= ascon_aead_decryptv(v->variant, key, nonce, adv, adcnt, inv, outv, cnt, tag) != -1;
+        for (size_t i = 0; i < sizeof(out); i++) wrong |= out[i] != SENTINEL;
+        if (wrong) {
+            printf("%s: mismatched fragment lengths were not rejected up front (adlen %d, mlen %d)\n", v->name,
+                   (int)adlen, (int)mlen);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+// Four lanes of different lengths, two of them in place, one with a modified tag; keyed
+// passes the key words preloaded (the _keys entry points) instead of lanes[i].k
+static int check_x4(const Variant* v, size_t adlen, size_t mlen, int keyed) {
+    uint8_t buf[ASCON_X4_LANES][MAX_MSG + CRYPTO_ABYTES], expected[ASCON_X4_LANES][MAX_MSG + CRYPTO_ABYTES];
+    ascon_lane_t lanes[ASCON_X4_LANES];
+    uint64_t K0[ASCON_X4_LANES], K1[ASCON_X4_LANES];
+    int failures = 0;
+
+    if (!v->rate) return 0;
+    for (int i = 0; i < ASCON_X4_LANES; i++) {
+        size_t lane_mlen = (mlen + 13 * i) % (MAX_MSG + 1), lane_adlen = (adlen + 7 * i) % (MAX_AD + 1);
+        encrypt_once(v->variant, lane_adlen, msg, lane_mlen, expected[i]);
+        memcpy(buf[i], msg, lane_mlen);
+        lanes[i].k = keyed ? NULL : key;
+        K0[i] = LOADBYTES(key, 8);
+        K1[i] = LOADBYTES(key + 8, 8);
+        lanes[i].npub = nonce;
+        lanes[i].ad = ad;
+        lanes[i].adlen = lane_adlen;
+        lanes[i].in = i & 1 ? buf[i] : msg;
+        lanes[i].inlen = lane_mlen;
+        lanes[i].out = buf[i];
+    }
+    int result = keyed ? ascon_aead_encrypt_x4_keys(lanes, K0, K1, ASCON_X4_LANES, v->rate)
+                       : ascon_aead_encrypt_x4(lanes, ASCON_X4_LANES, v->rate);
+    if (result != 0) failures++;
+    for (int i = 0; i < ASCON_X4_LANES; i++) {
+        if (lanes[i].outlen != lanes[i].inlen + CRYPTO_ABYTES || memcmp(buf[i], expected[i], lanes[i].outlen) != 0) {
+            printf("%s: x4%s encryption differs (lane %d, adlen %d, mlen %d)\n", v->name, keyed ? " keys" : "", i,
+                   (int)lanes[i].adlen, (int)lanes[i].inlen);
+            failures++;
+        }
+        lanes[i].in = expected[i];
+        lanes[i].inlen += CRYPTO_ABYTES;
+        if (i & 1) {
+            memcpy(buf[i], expected[i], lanes[i].inlen);
+            lanes[i].in = buf[i];
+        }
+    }
+    expected[2][lanes[2].inlen - 1] ^= 0x01;
+    result = keyed ? ascon_aead_decrypt_x4_keys(lanes, K0, K1, ASCON_X4_LANES, v->rate)
+                   : ascon_aead_decrypt_x4(lanes, ASCON_X4_LANES, v->rate);
+    if (result == 0) failures++;
+    for (int i = 0; i < ASCON_X4_LANES; i++) {
+        int ok = i == 2 ? lanes[i].result != 0
+                        : lanes[i].result == 0 && memcmp(buf[i], msg, lanes[i].inlen - CRYPTO_ABYTES) == 0;
+        if (!ok) {
+            printf("%s: x4%s decryption wrong (lane %d, adlen %d, mlen %d)\n", v->name, keyed ? " keys" : "", i,
+                   (int)lanes[i].adlen, (int)(lanes[i].inlen - CRYPTO_ABYTES));
+            failures++;
+        }
+    }
+    return failures;
+}
+
+// ascon_encrypt_batch/ascon_decrypt_batch against the one-shot functions: packets of all
+// variants, two keys each, random lengths, separate buffers and in place, tampered and short
+// ciphertexts and packets of a session that ascon_session_init() rejected
+static int check_batch(void) {
+    static uint8_t expected[BATCH_PACKETS][MAX_MSG + CRYPTO_ABYTES], buf[BATCH_PACKETS][MAX_MSG + CRYPTO_ABYTES];
+    static uint8_t nonces[BATCH_PACKETS][CRYPTO_NPUBBYTES];
+    static ascon_packet_t packets[BATCH_PACKETS];
+    ascon_session_t sessions[8]; // 6, 7: invalid
+    uint8_t keys[6][ASCON_80PQ_KEYBYTES];
+    size_t expected_failed = 0;
+    int failures = 0;
+
+    for (int s = 0; s < 6; s++) {
+        for (int i = 0; i < ASCON_80PQ_KEYBYTES; i++) keys[s][i] = (uint8_t)(17 * s + i);
+        ascon_session_init(&sessions[s], s / 2, keys[s]);
+    }
+    if (ascon_session_init(&sessions[6], 7, keys[0]) == 0) {
+        printf("Batch: session with variant 7 accepted\n");
+        failures++;
+    }
+    memset(&sessions[7], 0, sizeof(sessions[7])); // never initialized
+
+    for (int i = 0; i < BATCH_PACKETS; i++) {
+        ascon_packet_t* p = &packets[i];
+        int s = i == BATCH_PACKETS / 2 ? 6 : i == BATCH_PACKETS / 3 ? 7 : (int)next_split(5);
+        size_t adlen = next_split(MAX_AD), mlen = next_split(MAX_MSG);
+        unsigned long long len;
+        for (int j = 0; j < CRYPTO_NPUBBYTES; j++) nonces[i][j] = (uint8_t)(i + 31 * j);
+        if (s < 6) variants[s / 2].encrypt(expected[i], &len, msg, mlen, ad, adlen, NULL, nonces[i], keys[s]);
+        memset(buf[i], SENTINEL, sizeof(buf[i]));
+        if (i & 1) memcpy(buf[i], msg, mlen);
+        p->session = &sessions[s];
+        p->npub = nonces[i];
+        p->ad = ad;
+        p->adlen = adlen;
+        p->in = i & 1 ? buf[i] : msg;
+        p->inlen = mlen;
+        p->out = buf[i];
+        expected_failed += s >= 6;
+    }
+    if (ascon_encrypt_batch(packets, BATCH_PACKETS) != expected_failed) failures++;
+    for (int i = 0; i < BATCH_PACKETS; i++) {
+        ascon_packet_t* p = &packets[i];
+        int ok = p->session >= &sessions[6]
+                     ? p->result != 0 && buf[i][0] == SENTINEL
+                     : p->result == 0 && p->outlen == p->inlen + CRYPTO_ABYTES &&
+                           memcmp(buf[i], expected[i], p->outlen) == 0;
+        if (!ok) {
+            printf("Batch: encryption wrong (packet %d, adlen %d, mlen %d)\n", i, (int)p->adlen, (int)p->inlen);
+            failures++;
+        }
+    }
+
+    // decrypt: every 5th packet tampered, packet 3 shorter than a tag
+    expected_failed = 0;
+    for (int i = 0; i < BATCH_PACKETS; i++) {
+        ascon_packet_t* p = &packets[i];
+        if (p->session >= &sessions[6]) {
+            expected_failed++;
+            continue;
+        }
+        size_t clen = p->inlen + CRYPTO_ABYTES;
+        memcpy(buf[i], expected[i], clen);
+        if (i % 5 == 0) buf[i][(i * 7) % clen] ^= 0x01;
+        p->in = buf[i];
+        p->inlen = i == 3 ? CRYPTO_ABYTES - 1 : clen;
+        if (!(i & 1)) {
+            memcpy(expected[i], buf[i], clen); // separate output, input is expected[i]
+            p->in = expected[i];
+            memset(buf[i], SENTINEL, sizeof(buf[i]));
+        }
+        expected_failed += i % 5 == 0 || i == 3;
+    }
+    if (ascon_decrypt_batch(packets, BATCH_PACKETS) != expected_failed) failures++;
+    for (int i = 0; i < BATCH_PACKETS; i++) {
+        ascon_packet_t* p = &packets[i];
+        int fail = p->session >= &sessions[6] || i % 5 == 0 || i == 3;
+        int ok = fail ? p->result != 0
+                      : p->result == 0 && p->outlen == p->inlen - CRYPTO_ABYTES && memcmp(buf[i], msg, p->outlen) == 0;
+        if (!ok) {
+            printf("Batch: decryption wrong (packet %d, adlen %d)\n", i, (int)p->adlen);
+            failures++;
+        }
+    }
+    printf("Batch: %d failures in %d packets\n", failures, BATCH_PACKETS);
+    return failures;
+}
+
+int check_variant(const Variant* v, uint32_t* checksum) {
+    uint8_t expected[MAX_MSG + CRYPTO_ABYTES];
+    int failures = 0, cases = 0;
+
+    for (size_t adlen = 0; adlen <= MAX_AD; adlen++) {
+        for (size_t mlen = 0; mlen <= MAX_MSG; mlen++) {
+            encrypt_once(v->variant, adlen, msg, mlen, expected);
+            for (size_t i = 0; i < mlen + CRYPTO_ABYTES; i++) {
+                *checksum = (*checksum ^ expected[i]) * 16777619u; // FNV-1a
+            }
+            int differs = check_stream(v, adlen, mlen, expected);
+            differs += check_one_shot(v, adlen, mlen, expected);
+            differs += check_iovec(v, adlen, mlen, expected);
+            differs += check_x4(v, adlen, mlen, 0);
+            differs += check_x4(v, adlen, mlen, 1);
+            failures += differs;
+            cases += differs != 0;
+        }
+    }
+    printf("%s: %d of %d cases failed\n", v->name, cases, (MAX_AD + 1) * (MAX_MSG + 1));
+    return failures;
+}
+
+int main(void) {
+    // Count = 1 of the Ascon-128 and Ascon-128a KATs: empty AD and message
+    static const uint8_t kat128[CRYPTO_ABYTES] = { 0xe3, 0x55, 0x15, 0x9f, 0x29, 0x29, 0x11, 0xf7,
+                                                   0x94, 0xcb, 0x14, 0x32, 0xa0, 0x10, 0x3a, 0x8a };
+    static const uint8_t kat128a[CRYPTO_ABYTES] = { 0x7a, 0x83, 0x4e, 0x6f, 0x09, 0x21, 0x09, 0x57,
+                                                    0x06, 0x7b, 0x10, 0xfd, 0x83, 0x1f, 0x00, 0x78 };
+    uint8_t tag[CRYPTO_ABYTES];
+    uint32_t checksum = 2166136261u;
+    int failures = 0;
+
+    for (int i = 0; i < ASCON_80PQ_KEYBYTES; i++) key[i] = (uint8_t)i;
+    for (int i = 0; i < CRYPTO_NPUBBYTES; i++) nonce[i] = (uint8_t)i;
+    printf("Checking the Ascon AEAD entry points (x4 engine: %s)\n", ascon_x4_avx2_supported() ? "AVX2" : "scalar");
+    encrypt_once(ASCON_AEAD_128, 0, msg, 0, tag);
+    if (memcmp(tag, kat128, CRYPTO_ABYTES) != 0) {
+        printf("Ascon-128: KAT tag differs\n");
+        failures++;
+    }
+    encrypt_once(ASCON_AEAD_128A, 0, msg, 0, tag);
+    if (memcmp(tag, kat128a, CRYPTO_ABYTES) != 0) {
+        printf("Ascon-128a: KAT tag differs\n");
+        failures++;
+    }
+
+    for (int i = 0; i < CRYPTO_NPUBBYTES; i++) nonce[i] = (uint8_t)(0x80 + i);
+    for (int i = 0; i < MAX_AD; i++) ad[i] = (uint8_t)(0x40 + 3 * i);
+    for (int i = 0; i < MAX_MSG; i++) msg[i] = (uint8_t)(7 * i + 1);
+    for (size_t i = 0; i < sizeof(variants) / sizeof(variants[0]); i++) {
+        failures += check_variant(&variants[i], &checksum);
+    }
+    failures += check_batch();
+    printf("Checksum of all ciphertexts and tags: %08lx\n", (unsigned long)checksum);
+    printf(failures ? "FAILED\n" : "OK\n");
+    return failures ? 1 : 0;
+}
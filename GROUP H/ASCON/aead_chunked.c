@@ -0,0 +1,497 @@
+#include "aead_chunked.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <io.h>
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <unistd.h>
+#endif
+
+#ifndef O_BINARY
+#define O_BINARY 0
+#endif
+
+#include "aead_avx2.h"
+#include "api.h"
+#include "bench.h"
+#include "constants.h"
+
+#ifdef _WIN32
+#define LOAD(p) InterlockedCompareExchange((p), 0, 0)
+#define STORE(p, v) InterlockedExchange((p), (v))
+#else
+#define LOAD(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#endif
+
+#define CF_MAGIC "ASCONCF1"
+#define CF_TRAILER_INDEX (~(uint64_t)0)
+#define CF_MAX_CHUNK (1u << 30)
+
+typedef struct {
+  unsigned char header[ASCON_CF_HEADER_BYTES];
+  const unsigned char* k;
+  uint32_t chunk_size;
+  int rate;
+  int decrypt;
+  int in_fd;
+  int out_fd;
+  uint64_t length; /* plaintext bytes */
+  uint64_t nchunks;
+  int num_threads;
+  volatile long failed; /* set by any worker, LOAD/STORE only */
+} cf_job_t;
+
+/* per-thread buffers for one group of ASCON_X4_LANES chunks */
+typedef struct {
+  unsigned char* in[ASCON_X4_LANES];
+  unsigned char* out[ASCON_X4_LANES];
+  unsigned char nonce[ASCON_X4_LANES][CRYPTO_NPUBBYTES];
+  unsigned char ad[ASCON_X4_LANES][ASCON_CF_AD_BYTES];
+  ascon_lane_t lanes[ASCON_X4_LANES];
+} cf_buf_t;
+
+typedef struct {
+  cf_job_t* job;
+  int thread_num;
+} cf_worker_t;
+
+static void cf_put64(unsigned char* p, uint64_t x) {
+  int i;
+  for (i = 0; i < 8; i++) p[i] = (unsigned char)(x >> (56 - 8 * i));
+}
+
+static uint64_t cf_get64(const unsigned char* p) {
+  uint64_t x = 0;
+  int i;
+  for (i = 0; i < 8; i++) x = x << 8 | p[i];
+  return x;
+}
+
+/* positional I/O, so threads can share one descriptor */
+static int cf_pread(int fd, unsigned char* buf, uint64_t len, uint64_t off) {
+  while (len) {
+#ifdef _WIN32
+    OVERLAPPED o;
+    DWORD got = 0;
+    memset(&o, 0, sizeof(o));
+    o.Offset = (DWORD)off;
+    o.OffsetHigh = (DWORD)(off >> 32);
+    if (!ReadFile((HANDLE)_get_osfhandle(fd), buf,
+                  (DWORD)(len > 0x40000000 ? 0x40000000 : len), &got, &o) ||
+        got == 0)
+      return -1;
+#else
+    ssize_t got = pread(fd, buf, len, (off_t)off);
+    if (got <= 0) return -1;
+#endif
+    buf += got;
+    off += got;
+    len -= got;
+  }
+  return 0;
+}
+
+static int cf_pwrite(int fd, const unsigned char* buf, uint64_t len,
+                     uint64_t off) {
+  while (len) {
+#ifdef _WIN32
+    OVERLAPPED o;
+    DWORD put = 0;
+    memset(&o, 0, sizeof(o));
+    o.Offset = (DWORD)off;
+    o.OffsetHigh = (DWORD)(off >> 32);
+    if (!WriteFile((HANDLE)_get_osfhandle(fd), buf,
+                   (DWORD)(len > 0x40000000 ? 0x40000000 : len), &put, &o) ||
+        put == 0)
+      return -1;
+#else
+    ssize_t put = pwrite(fd, buf, len, (off_t)off);
+    if (put <= 0) return -1;
+#endif
+    buf += put;
+    off += put;
+    len -= put;
+  }
+  return 0;
+}
+
+static int64_t cf_file_size(int fd) {
+#ifdef _WIN32
+  return _lseeki64(fd, 0, SEEK_END);
+#else
+  return (int64_t)lseek(fd, 0, SEEK_END);
+#endif
+}
+
+static uint64_t cf_chunk_offset(const cf_job_t* job, uint64_t i) {
+  return ASCON_CF_HEADER_BYTES + i * ((uint64_t)job->chunk_size + CRYPTO_ABYTES);
+}
+
+static uint64_t cf_chunk_length(const cf_job_t* job, uint64_t i) {
+  uint64_t start = i * job->chunk_size;
+  uint64_t left = job->length - start;
+  return left < job->chunk_size ? left : job->chunk_size;
+}
+
+int ascon_cf_header(unsigned char* header, const unsigned char* nonce,
+                    uint32_t chunk_size, int variant) {
+  if (chunk_size == 0 || chunk_size > CF_MAX_CHUNK) return -1;
+  if (variant != ASCON_CF_VARIANT_128 && variant != ASCON_CF_VARIANT_128A)
+    return -1;
+  memset(header, 0, ASCON_CF_HEADER_BYTES);
+  memcpy(header, CF_MAGIC, 8);
+  header[8] = (unsigned char)variant;
+  header[12] = (unsigned char)(chunk_size >> 24);
+  header[13] = (unsigned char)(chunk_size >> 16);
+  header[14] = (unsigned char)(chunk_size >> 8);
+  header[15] = (unsigned char)chunk_size;
+  memcpy(header + 16, nonce, CRYPTO_NPUBBYTES);
+  return 0;
+}
+
+int ascon_cf_parse(const unsigned char* header, uint32_t* chunk_size,
+                   int* rate) {
+  if (memcmp(header, CF_MAGIC, 8)) return -1;
+  if (header[8] == ASCON_CF_VARIANT_128)
+    *rate = ASCON_128_RATE;
+  else if (header[8] == ASCON_CF_VARIANT_128A)
+    *rate = ASCON_128A_RATE;
+  else
+    return -1;
+  *chunk_size = (uint32_t)header[12] << 24 | (uint32_t)header[13] << 16 |
+                (uint32_t)header[14] << 8 | header[15];
+  if (*chunk_size == 0 || *chunk_size > CF_MAX_CHUNK) return -1;
+  return 0;
+}
+
+/* file nonce with the chunk index xored into its last 8 bytes */
+void ascon_cf_chunk(const unsigned char* header, uint64_t i, int final,
+                    unsigned char* nonce, unsigned char* ad) {
+  memcpy(nonce, header + 16, CRYPTO_NPUBBYTES);
+  cf_put64(nonce + 8, cf_get64(nonce + 8) ^ i);
+  if (!ad) return;
+  memcpy(ad, header, ASCON_CF_HEADER_BYTES);
+  cf_put64(ad + ASCON_CF_HEADER_BYTES, i);
+  ad[ASCON_CF_HEADER_BYTES + 8] = final != 0;
+}
+
+/* empty message with header || plaintext length as AD: tag only */
+static int cf_trailer(const unsigned char* header, const unsigned char* k,
+                      unsigned char* trailer, int verify) {
+  unsigned char ad[ASCON_CF_HEADER_BYTES + 8];
+  unsigned char nonce[CRYPTO_NPUBBYTES];
+  unsigned char empty[1];
+  uint32_t chunk_size;
+  int rate;
+  ascon_lane_t lane;
+
+  if (ascon_cf_parse(header, &chunk_size, &rate)) return -1;
+  memcpy(ad, header, ASCON_CF_HEADER_BYTES);
+  memcpy(ad + ASCON_CF_HEADER_BYTES, trailer, 8);
+  ascon_cf_chunk(header, CF_TRAILER_INDEX, 0, nonce, NULL);
+  memset(&lane, 0, sizeof(lane));
+  lane.k = k;
+  lane.npub = nonce;
+  lane.ad = ad;
+  lane.adlen = sizeof(ad);
+  if (verify) {
+    lane.in = trailer + 8;
+    lane.inlen = CRYPTO_ABYTES;
+    lane.out = empty;
+    return ascon_aead_decrypt_x4(&lane, 1, rate);
+  }
+  lane.in = empty;
+  lane.inlen = 0;
+  lane.out = trailer + 8;
+  return ascon_aead_encrypt_x4(&lane, 1, rate);
+}
+
+int ascon_cf_seal_trailer(const unsigned char* header, const unsigned char* k,
+                          uint64_t length, unsigned char* trailer) {
+  cf_put64(trailer, length);
+  return cf_trailer(header, k, trailer, 0);
+}
+
+int ascon_cf_open_trailer(const unsigned char* header, const unsigned char* k,
+                          const unsigned char* trailer, uint64_t* length) {
+  unsigned char t[ASCON_CF_TRAILER_BYTES];
+  memcpy(t, trailer, ASCON_CF_TRAILER_BYTES);
+  if (cf_trailer(header, k, t, 1)) return -1;
+  *length = cf_get64(t);
+  return 0;
+}
+
+/* read, encrypt or decrypt chunks first .. first + n - 1 into buf->out */
+static int cf_group(cf_job_t* job, cf_buf_t* buf, uint64_t first, int n) {
+  int l;
+  for (l = 0; l < n; l++) {
+    uint64_t i = first + l;
+    uint64_t plen = cf_chunk_length(job, i);
+    ascon_lane_t* lane = &buf->lanes[l];
+    ascon_cf_chunk(job->header, i, i + 1 == job->nchunks, buf->nonce[l],
+                   buf->ad[l]);
+    lane->k = job->k;
+    lane->npub = buf->nonce[l];
+    lane->ad = buf->ad[l];
+    lane->adlen = ASCON_CF_AD_BYTES;
+    lane->in = buf->in[l];
+    lane->out = buf->out[l];
+    if (job->decrypt) {
+      lane->inlen = plen + CRYPTO_ABYTES;
+      if (cf_pread(job->in_fd, buf->in[l], lane->inlen, cf_chunk_offset(job, i)))
+        return -1;
+    } else {
+      lane->inlen = plen;
+      if (cf_pread(job->in_fd, buf->in[l], plen, i * job->chunk_size))
+        return -1;
+    }
+  }
+  if (job->decrypt) return ascon_aead_decrypt_x4(buf->lanes, n, job->rate);
+  return ascon_aead_encrypt_x4(buf->lanes, n, job->rate);
+}
+
+static int cf_alloc(cf_buf_t* buf, uint32_t chunk_size) {
+  int l, ok = 1;
+  for (l = 0; l < ASCON_X4_LANES; l++) {
+    buf->in[l] = malloc((size_t)chunk_size + CRYPTO_ABYTES);
+    buf->out[l] = malloc((size_t)chunk_size + CRYPTO_ABYTES);
+    ok &= buf->in[l] && buf->out[l];
+  }
+  return ok ? 0 : -1;
+}
+
+static void cf_free(cf_buf_t* buf) {
+  int l;
+  for (l = 0; l < ASCON_X4_LANES; l++) {
+    free(buf->in[l]);
+    free(buf->out[l]);
+  }
+}
+
+/* thread t handles groups t, t + num_threads, ... */
+static void* cf_worker(void* args) {
+  cf_worker_t* w = (cf_worker_t*)args;
+  cf_job_t* job = w->job;
+  uint64_t ngroups = (job->nchunks + ASCON_X4_LANES - 1) / ASCON_X4_LANES;
+  uint64_t g;
+  cf_buf_t buf;
+
+  if (cf_alloc(&buf, job->chunk_size)) {
+    STORE(&job->failed, 1);
+    cf_free(&buf);
+    return NULL;
+  }
+  for (g = w->thread_num; g < ngroups && !LOAD(&job->failed);
+       g += job->num_threads) {
+    uint64_t first = g * ASCON_X4_LANES;
+    int n = job->nchunks - first < ASCON_X4_LANES ? (int)(job->nchunks - first)
+                                                  : ASCON_X4_LANES;
+    int l;
+    if (cf_group(job, &buf, first, n)) {
+      STORE(&job->failed, 1);
+      break;
+    }
+    for (l = 0; l < n; l++) {
+      uint64_t i = first + l;
+      uint64_t off = job->decrypt ? i * job->chunk_size : cf_chunk_offset(job, i);
+      if (cf_pwrite(job->out_fd, buf.out[l], buf.lanes[l].outlen, off)) {
+        STORE(&job->failed, 1);
+        break;
+      }
+    }
+  }
+  cf_free(&buf);
+  return NULL;
+}
+
+static int cf_run(cf_job_t* job) {
+  int i, n = job->num_threads;
+  cf_worker_t* workers = malloc(n * sizeof(cf_worker_t));
+#ifdef _WIN32
+  HANDLE* threads = malloc(n * sizeof(HANDLE));
+#else
+  pthread_t* threads = malloc(n * sizeof(pthread_t));
+#endif
+  if (!workers || !threads) {
+    free(workers);
+    free(threads);
+    return -1;
+  }
+  /* threads that started; the groups of the others are not processed, so a
+   * failed start fails the whole job */
+  for (i = 0; i < n; i++) {
+    workers[i].job = job;
+    workers[i].thread_num = i;
+#ifdef _WIN32
+    threads[i] = CreateThread(NULL, 0, (LPTHREAD_START_ROUTINE)cf_worker,
+                              &workers[i], 0, NULL);
+    if (!threads[i]) break;
+#else
+    if (pthread_create(&threads[i], NULL, cf_worker, &workers[i])) break;
+#endif
+  }
+  if (i < n) STORE(&job->failed, 1);
+  n = i;
+#ifdef _WIN32
+  if (n) WaitForMultipleObjects(n, threads, TRUE, INFINITE);
+  for (i = 0; i < n; i++) CloseHandle(threads[i]);
+#else
+  for (i = 0; i < n; i++) pthread_join(threads[i], NULL);
+#endif
+  free(workers);
+  free(threads);
+  return LOAD(&job->failed) ? -1 : 0;
+}
+
+static void cf_threads(cf_job_t* job, int num_threads) {
+  uint64_t ngroups = (job->nchunks + ASCON_X4_LANES - 1) / ASCON_X4_LANES;
+  if (num_threads <= 0) num_threads = bench_num_cores();
+  if ((uint64_t)num_threads > ngroups) num_threads = ngroups ? (int)ngroups : 1;
+  job->num_threads = num_threads;
+}
+
+/* opens path, reads the header and verifies the trailer */
+static int cf_open(cf_job_t* job, const char* path, const unsigned char* k) {
+  unsigned char trailer[ASCON_CF_TRAILER_BYTES];
+  int64_t size;
+
+  memset(job, 0, sizeof(*job));
+  job->k = k;
+  job->decrypt = 1;
+  job->out_fd = -1;
+  job->in_fd = open(path, O_RDONLY | O_BINARY);
+  if (job->in_fd < 0) return -1;
+  size = cf_file_size(job->in_fd);
+  if (size < ASCON_CF_HEADER_BYTES + ASCON_CF_TRAILER_BYTES ||
+      cf_pread(job->in_fd, job->header, ASCON_CF_HEADER_BYTES, 0) ||
+      ascon_cf_parse(job->header, &job->chunk_size, &job->rate) ||
+      cf_pread(job->in_fd, trailer, ASCON_CF_TRAILER_BYTES,
+               size - ASCON_CF_TRAILER_BYTES) ||
+      ascon_cf_open_trailer(job->header, k, trailer, &job->length))
+    goto fail;
+  job->nchunks = (job->length + job->chunk_size - 1) / job->chunk_size;
+  /* truncated or padded between the chunks and the trailer */
+  if ((uint64_t)size != cf_chunk_offset(job, job->nchunks) -
+                            job->nchunks * job->chunk_size + job->length +
+                            ASCON_CF_TRAILER_BYTES)
+    goto fail;
+  return 0;
+fail:
+  close(job->in_fd);
+  return -1;
+}
+
+int ascon_cf_encrypt_file(const char* in_path, const char* out_path,
+                          const unsigned char* k, const unsigned char* nonce,
+                          uint32_t chunk_size, int variant, int num_threads) {
+  unsigned char trailer[ASCON_CF_TRAILER_BYTES];
+  cf_job_t job;
+  int64_t size;
+  int result = -1;
+
+  memset(&job, 0, sizeof(job));
+  if (ascon_cf_header(job.header, nonce, chunk_size, variant)) return -1;
+  ascon_cf_parse(job.header, &job.chunk_size, &job.rate);
+  job.k = k;
+
+  job.in_fd = open(in_path, O_RDONLY | O_BINARY);
+  if (job.in_fd < 0) return -1;
+  job.out_fd = open(out_path, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644);
+  if (job.out_fd < 0) {
+    close(job.in_fd);
+    return -1;
+  }
+  size = cf_file_size(job.in_fd);
+  if (size >= 0) {
+    job.length = (uint64_t)size;
+    job.nchunks = (job.length + chunk_size - 1) / chunk_size;
+    cf_threads(&job, num_threads);
+    if (!cf_pwrite(job.out_fd, job.header, ASCON_CF_HEADER_BYTES, 0) &&
+        !cf_run(&job) &&
+        !ascon_cf_seal_trailer(job.header, k, job.length, trailer) &&
+        !cf_pwrite(job.out_fd, trailer, ASCON_CF_TRAILER_BYTES,
+                   cf_chunk_offset(&job, job.nchunks) -
+                       job.nchunks * chunk_size + job.length))
+      result = 0;
+  }
+  close(job.in_fd);
+  close(job.out_fd);
+  return result;
+}
+
+int ascon_cf_decrypt_file(const char* in_path, const char* out_path,
+                          const unsigned char* k, int num_threads) {
+  cf_job_t job;
+  int result;
+
+  if (cf_open(&job, in_path, k)) return -1;
+  job.out_fd = open(out_path, O_WRONLY | O_CREAT | O_TRUNC | O_BINARY, 0644);
+  if (job.out_fd < 0) {
+    close(job.in_fd);
+    return -1;
+  }
+  cf_threads(&job, num_threads);
+  result = cf_run(&job);
+  close(job.in_fd);
+  close(job.out_fd);
+  if (result) remove(out_path);
+  return result;
+}
+
+int ascon_cf_plaintext_length(const char* path, const unsigned char* k,
+                              uint64_t* length) {
+  cf_job_t job;
+  if (cf_open(&job, path, k)) return -1;
+  *length = job.length;
+  close(job.in_fd);
+  return 0;
+}
+
+int ascon_cf_decrypt_range(const char* path, const unsigned char* k,
+                           uint64_t offset, uint64_t len, unsigned char* out) {
+  cf_job_t job;
+  cf_buf_t buf;
+  uint64_t first, last, i;
+  int result = 0;
+
+  if (cf_open(&job, path, k)) return -1;
+  if (offset > job.length || len > job.length - offset) {
+    close(job.in_fd);
+    return -1;
+  }
+  if (len == 0) {
+    close(job.in_fd);
+    return 0;
+  }
+  if (cf_alloc(&buf, job.chunk_size)) {
+    cf_free(&buf);
+    close(job.in_fd);
+    return -1;
+  }
+  first = offset / job.chunk_size;
+  last = (offset + len - 1) / job.chunk_size;
+  for (i = first; i <= last && !result; i += ASCON_X4_LANES) {
+    int n = last - i + 1 < ASCON_X4_LANES ? (int)(last - i + 1) : ASCON_X4_LANES;
+    int l;
+    result = cf_group(&job, &buf, i, n);
+    for (l = 0; l < n && !result; l++) {
+      /* overlap of chunk i + l with the requested range */
+      uint64_t start = (i + l) * job.chunk_size;
+      uint64_t from = offset > start ? offset - start : 0;
+      uint64_t to = buf.lanes[l].outlen;
+      if (start + to > offset + len) to = offset + len - start;
+      memcpy(out + (start + from - offset), buf.out[l] + from, to - from);
+    }
+  }
+  if (result) memset(out, 0, len);
+  cf_free(&buf);
+  close(job.in_fd);
+  return result;
+}
@@ -0,0 +1,64 @@
+#ifndef AEAD_CHUNKED_H_
+#define AEAD_CHUNKED_H_
+
+#include <stdint.h>
+
+/* Chunked Ascon container
+ *
+ *   header   32 bytes   "ASCONCF1", variant, 3 reserved bytes,
+ *                       chunk size (32-bit big-endian), file nonce (16)
+ *   chunk i  <= chunk size bytes of ciphertext, 16-byte tag
+ *   trailer  24 bytes   plaintext length (64-bit big-endian), 16-byte tag
+ *
+ * Chunk i is encrypted with the file nonce whose last 8 bytes are xored with
+ * i, and with header || i || final flag as associated data. Moving a chunk
+ * changes its nonce and AD, and dropping the tail leaves a chunk without
+ * the final flag. The trailer authenticates the plaintext length under its
+ * own nonce (index 2^64 - 1), so a missing or cut trailer is detected too.
+ * All chunks are full except the last one, so chunk i starts at
+ * ASCON_CF_HEADER_BYTES + i * (chunk size + CRYPTO_ABYTES) and any range can
+ * be decrypted from the header, the trailer and the chunks it covers. */
+
+#define ASCON_CF_HEADER_BYTES 32
+#define ASCON_CF_TRAILER_BYTES 24
+#define ASCON_CF_AD_BYTES (ASCON_CF_HEADER_BYTES + 8 + 1)
+#define ASCON_CF_DEFAULT_CHUNK (1024 * 1024)
+
+#define ASCON_CF_VARIANT_128 0
+#define ASCON_CF_VARIANT_128A 1
+
+/* All functions return 0 on success and -1 on I/O errors, malformed input
+ * or failed authentication. num_threads <= 0 uses one thread per core. */
+int ascon_cf_encrypt_file(const char* in_path, const char* out_path,
+                          const unsigned char* k, const unsigned char* nonce,
+                          uint32_t chunk_size, int variant, int num_threads);
+
+/* Removes out_path again if any chunk fails to authenticate. */
+int ascon_cf_decrypt_file(const char* in_path, const char* out_path,
+                          const unsigned char* k, int num_threads);
+
+/* Plaintext length of a container, authenticated through the trailer. */
+int ascon_cf_plaintext_length(const char* path, const unsigned char* k,
+                              uint64_t* length);
+
+/* Decrypts plaintext bytes [offset, offset + len) into out, reading only
+ * the header, the trailer and the chunks that overlap the range. */
+int ascon_cf_decrypt_range(const char* path, const unsigned char* k,
+                           uint64_t offset, uint64_t len, unsigned char* out);
+
+/* Building blocks for other engines reading or writing the same format
+ * (aead_pipeline.c). ascon_cf_header() and ascon_cf_parse() return -1 for
+ * an invalid chunk size or variant. ascon_cf_chunk() writes the nonce and,
+ * unless ad is NULL, the ASCON_CF_AD_BYTES of associated data of chunk i. */
+int ascon_cf_header(unsigned char* header, const unsigned char* nonce,
+                    uint32_t chunk_size, int variant);
+int ascon_cf_parse(const unsigned char* header, uint32_t* chunk_size,
+                   int* rate);
+void ascon_cf_chunk(const unsigned char* header, uint64_t i, int final,
+                    unsigned char* nonce, unsigned char* ad);
+int ascon_cf_seal_trailer(const unsigned char* header, const unsigned char* k,
+                          uint64_t length, unsigned char* trailer);
+int ascon_cf_open_trailer(const unsigned char* header, const unsigned char* k,
+                          const unsigned char* trailer, uint64_t* length);
+
+#endif /* AEAD_CHUNKED_H_ */
@@ -0,0 +1,507 @@
+#include "aead_pipeline.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <io.h>
+#include <malloc.h>
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#include "aead_avx2.h"
+#include "aead_chunked.h"
+#include "api.h"
+#include "bench.h"
+
+#define PIPE_ALIGN 4096
+#define PIPE_CACHE_LINE 64
+#define PIPE_SPINS 256 /* polls before a waiting thread goes to sleep */
+
+#ifdef _WIN32
+#define LOAD(p) InterlockedCompareExchange64((p), 0, 0)
+#define STORE(p, v) InterlockedExchange64((p), (v))
+#define CAS(p, old, new) \
+  (InterlockedCompareExchange64((p), (new), (old)) == (old))
+#define LOAD_SC(p) InterlockedCompareExchange64((p), 0, 0)
+#define INC(p) InterlockedIncrement64(p)
+#define DEC(p) InterlockedDecrement64(p)
+#define YIELD() SwitchToThread()
+#define read _read
+#define write _write
+#define lseek _lseeki64
+#else
+#define LOAD(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define CAS(p, old, new)                                            \
+  __atomic_compare_exchange_n((p), &(old), (new), 0, __ATOMIC_RELAXED, \
+                              __ATOMIC_RELAXED)
+#define LOAD_SC(p) __atomic_load_n((p), __ATOMIC_SEQ_CST)
+#define INC(p) __atomic_add_fetch((p), 1, __ATOMIC_SEQ_CST)
+#define DEC(p) __atomic_sub_fetch((p), 1, __ATOMIC_SEQ_CST)
+#define YIELD() sched_yield()
+#endif
+
+/* Bounded multi-producer multi-consumer queue of buffer indices (Vyukov):
+ * every cell carries a sequence number that tells producers and consumers
+ * whether it is free for position pos or holds the item of position pos. */
+typedef struct {
+  volatile int64_t seq;
+  int slot;
+} pipe_cell_t;
+
+typedef struct {
+  pipe_cell_t* cells;
+  int64_t mask;
+  char pad0[PIPE_CACHE_LINE];
+  volatile int64_t head; /* next push */
+  char pad1[PIPE_CACHE_LINE];
+  volatile int64_t tail; /* next pop */
+  char pad2[PIPE_CACHE_LINE];
+} pipe_queue_t;
+
+/* one input and one output buffer and the chunk they hold */
+typedef struct {
+  unsigned char* in;
+  unsigned char* out;
+  uint64_t index;
+  uint32_t len; /* bytes in in */
+  int final;
+  unsigned long long outlen;
+  int result;
+} pipe_slot_t;
+
+typedef struct {
+  unsigned char header[ASCON_CF_HEADER_BYTES];
+  const unsigned char* k;
+  uint32_t chunk_size;
+  int rate;
+  int decrypt;
+  int in_fd;
+  int out_fd;
+  uint64_t expect_chunks; /* decryption: from the trailer */
+  uint64_t expect_length;
+  pipe_slot_t* slots;
+  int depth;
+  pipe_queue_t free_q, work_q, done_q;
+  volatile int64_t nchunks; /* set by the reader at the end */
+  volatile int64_t length;
+  volatile int64_t reader_done;
+  volatile int64_t stop;
+  volatile int64_t failed;
+  /* a thread that found nothing to do for PIPE_SPINS polls sleeps until
+   * events changes; pipe_wake() counts every push and state change */
+  volatile int64_t events;
+  volatile int64_t sleepers;
+#ifdef _WIN32
+  CRITICAL_SECTION lock;
+  CONDITION_VARIABLE wake;
+#else
+  pthread_mutex_t lock;
+  pthread_cond_t wake;
+#endif
+} pipe_job_t;
+
+static int pipe_queue_init(pipe_queue_t* q, int depth) {
+  int64_t i, size = 1;
+  while (size < depth) size <<= 1;
+  q->cells = malloc(size * sizeof(pipe_cell_t));
+  if (!q->cells) return -1;
+  for (i = 0; i < size; i++) q->cells[i].seq = i;
+  q->mask = size - 1;
+  q->head = 0;
+  q->tail = 0;
+  return 0;
+}
+
+static int pipe_push(pipe_queue_t* q, int slot) {
+  int64_t pos = LOAD(&q->head);
+  for (;;) {
+    pipe_cell_t* cell = &q->cells[pos & q->mask];
+    int64_t dif = LOAD(&cell->seq) - pos;
+    if (dif == 0) {
+      if (CAS(&q->head, pos, pos + 1)) {
+        cell->slot = slot;
+        STORE(&cell->seq, pos + 1);
+        return 1;
+      }
+    } else if (dif < 0) {
+      return 0; /* full */
+    }
+    pos = LOAD(&q->head);
+  }
+}
+
+static int pipe_pop(pipe_queue_t* q, int* slot) {
+  int64_t pos = LOAD(&q->tail);
+  for (;;) {
+    pipe_cell_t* cell = &q->cells[pos & q->mask];
+    int64_t dif = LOAD(&cell->seq) - (pos + 1);
+    if (dif == 0) {
+      if (CAS(&q->tail, pos, pos + 1)) {
+        *slot = cell->slot;
+        STORE(&cell->seq, pos + q->mask + 1);
+        return 1;
+      }
+    } else if (dif < 0) {
+      return 0; /* empty */
+    }
+    pos = LOAD(&q->tail);
+  }
+}
+
+/* The lock is only taken when somebody sleeps: a waker that sees no
+ * sleeper after counting its event cannot miss one, because a sleeper
+ * registers before it compares events with what it saw before its check. */
+static void pipe_wake(pipe_job_t* job) {
+  INC(&job->events);
+  if (!LOAD_SC(&job->sleepers)) return;
+#ifdef _WIN32
+  EnterCriticalSection(&job->lock);
+  WakeAllConditionVariable(&job->wake);
+  LeaveCriticalSection(&job->lock);
+#else
+  pthread_mutex_lock(&job->lock);
+  pthread_cond_broadcast(&job->wake);
+  pthread_mutex_unlock(&job->lock);
+#endif
+}
+
+/* seen: job->events read before the caller found nothing to do */
+static void pipe_idle(pipe_job_t* job, int* spins, int64_t seen) {
+  if (++*spins < PIPE_SPINS) {
+    YIELD();
+    return;
+  }
+#ifdef _WIN32
+  EnterCriticalSection(&job->lock);
+  INC(&job->sleepers);
+  while (LOAD_SC(&job->events) == seen)
+    SleepConditionVariableCS(&job->wake, &job->lock, INFINITE);
+  DEC(&job->sleepers);
+  LeaveCriticalSection(&job->lock);
+#else
+  pthread_mutex_lock(&job->lock);
+  INC(&job->sleepers);
+  while (LOAD_SC(&job->events) == seen)
+    pthread_cond_wait(&job->wake, &job->lock);
+  DEC(&job->sleepers);
+  pthread_mutex_unlock(&job->lock);
+#endif
+  *spins = 0;
+}
+
+static void pipe_set(pipe_job_t* job, volatile int64_t* flag) {
+  STORE(flag, 1);
+  pipe_wake(job);
+}
+
+/* every queue can hold all buffers, so this only spins on a race */
+static void pipe_push_wait(pipe_job_t* job, pipe_queue_t* q, int slot) {
+  while (!pipe_push(q, slot)) YIELD();
+  pipe_wake(job);
+}
+
+/* 0 once the job stopped or failed */
+static int pipe_pop_wait(pipe_job_t* job, pipe_queue_t* q, int* slot) {
+  int spins = 0;
+  for (;;) {
+    int64_t seen = LOAD(&job->events);
+    if (pipe_pop(q, slot)) return 1;
+    if (LOAD(&job->stop) || LOAD(&job->failed)) return 0;
+    pipe_idle(job, &spins, seen);
+  }
+}
+
+static int64_t read_full(int fd, unsigned char* buf, uint32_t len) {
+  int64_t total = 0;
+  while (total < len) {
+    int64_t got = read(fd, buf + total, len - (uint32_t)total);
+    if (got < 0) return -1;
+    if (got == 0) break;
+    total += got;
+  }
+  return total;
+}
+
+static int write_full(int fd, const unsigned char* buf, uint64_t len) {
+  while (len) {
+    int64_t put =
+        write(fd, buf, len > 0x40000000 ? 0x40000000 : (unsigned int)len);
+    if (put <= 0) return -1;
+    buf += put;
+    len -= put;
+  }
+  return 0;
+}
+
+static void* pipe_alloc(size_t size) {
+#ifdef _WIN32
+  return _aligned_malloc(size, PIPE_ALIGN);
+#else
+  void* p;
+  return posix_memalign(&p, PIPE_ALIGN, size) ? NULL : p;
+#endif
+}
+
+static void pipe_free(void* p) {
+#ifdef _WIN32
+  _aligned_free(p);
+#else
+  free(p);
+#endif
+}
+
+/* Reads chunk after chunk into free buffers. A chunk is only queued once
+ * the next read shows whether more data follows, which is how the final
+ * chunk flag is known for input of unknown length. */
+static void* pipe_reader(void* args) {
+  pipe_job_t* job = (pipe_job_t*)args;
+  uint64_t index = 0, length = 0;
+  int held = -1;
+
+  for (;;) {
+    uint32_t want = job->chunk_size;
+    int64_t got;
+    int s;
+    if (job->decrypt) {
+      uint64_t left;
+      if (index == job->expect_chunks) break;
+      left = job->expect_length - index * job->chunk_size;
+      if (left < want) want = (uint32_t)left;
+      want += CRYPTO_ABYTES;
+    }
+    if (!pipe_pop_wait(job, &job->free_q, &s)) return NULL;
+    got = read_full(job->in_fd, job->slots[s].in, want);
+    if (got < 0 || (job->decrypt && got != want)) {
+      pipe_set(job, &job->failed);
+      return NULL;
+    }
+    if (got == 0) {
+      pipe_push_wait(job, &job->free_q, s);
+      break;
+    }
+    if (held >= 0) pipe_push_wait(job, &job->work_q, held);
+    job->slots[s].index = index++;
+    job->slots[s].len = (uint32_t)got;
+    job->slots[s].final = 0;
+    length += job->decrypt ? got - CRYPTO_ABYTES : got;
+    held = s;
+    if (got < want) break;
+  }
+  if (held >= 0) {
+    job->slots[held].final = 1;
+    pipe_push_wait(job, &job->work_q, held);
+  }
+  STORE(&job->nchunks, (int64_t)index);
+  STORE(&job->length, (int64_t)length);
+  pipe_set(job, &job->reader_done);
+  return NULL;
+}
+
+/* takes whatever is queued, up to 4 chunks, for one 4-lane call */
+static void* pipe_worker(void* args) {
+  pipe_job_t* job = (pipe_job_t*)args;
+  unsigned char nonce[ASCON_X4_LANES][CRYPTO_NPUBBYTES];
+  unsigned char ad[ASCON_X4_LANES][ASCON_CF_AD_BYTES];
+  ascon_lane_t lanes[ASCON_X4_LANES];
+  int s[ASCON_X4_LANES];
+
+  while (pipe_pop_wait(job, &job->work_q, &s[0])) {
+    int l, n = 1;
+    while (n < ASCON_X4_LANES && pipe_pop(&job->work_q, &s[n])) n++;
+    for (l = 0; l < n; l++) {
+      pipe_slot_t* slot = &job->slots[s[l]];
+      ascon_cf_chunk(job->header, slot->index, slot->final, nonce[l], ad[l]);
+      memset(&lanes[l], 0, sizeof(lanes[l]));
+      lanes[l].k = job->k;
+      lanes[l].npub = nonce[l];
+      lanes[l].ad = ad[l];
+      lanes[l].adlen = ASCON_CF_AD_BYTES;
+      lanes[l].in = slot->in;
+      lanes[l].inlen = slot->len;
+      lanes[l].out = slot->out;
+    }
+    if (job->decrypt)
+      ascon_aead_decrypt_x4(lanes, n, job->rate);
+    else
+      ascon_aead_encrypt_x4(lanes, n, job->rate);
+    for (l = 0; l < n; l++) {
+      job->slots[s[l]].outlen = lanes[l].outlen;
+      job->slots[s[l]].result = lanes[l].result;
+      pipe_push_wait(job, &job->done_q, s[l]);
+    }
+  }
+  return NULL;
+}
+
+/* Runs in the calling thread: writes chunks in file order. At most depth
+ * chunks are in flight, so index % depth identifies a pending chunk. */
+static void pipe_writer(pipe_job_t* job) {
+  int* pending = malloc(job->depth * sizeof(int));
+  uint64_t next = 0;
+  int i, s, spins = 0;
+
+  if (!pending) {
+    pipe_set(job, &job->failed);
+    return;
+  }
+  for (i = 0; i < job->depth; i++) pending[i] = -1;
+  for (;;) {
+    int64_t seen = LOAD(&job->events);
+    if (LOAD(&job->failed)) break;
+    if (LOAD(&job->reader_done) && next == (uint64_t)LOAD(&job->nchunks))
+      break;
+    if (!pipe_pop(&job->done_q, &s)) {
+      pipe_idle(job, &spins, seen);
+      continue;
+    }
+    spins = 0;
+    pending[job->slots[s].index % job->depth] = s;
+    while ((s = pending[next % job->depth]) >= 0) {
+      pipe_slot_t* slot = &job->slots[s];
+      pending[next % job->depth] = -1;
+      if (slot->result || write_full(job->out_fd, slot->out, slot->outlen)) {
+        pipe_set(job, &job->failed);
+        break;
+      }
+      pipe_push_wait(job, &job->free_q, s);
+      next++;
+    }
+  }
+  free(pending);
+}
+
+static int pipe_run(pipe_job_t* job, int num_workers, int depth) {
+  int i, n, result = -1;
+#ifdef _WIN32
+  HANDLE* threads;
+#else
+  pthread_t* threads;
+#endif
+
+#ifdef _WIN32
+  InitializeCriticalSection(&job->lock);
+  InitializeConditionVariable(&job->wake);
+#else
+  pthread_mutex_init(&job->lock, NULL);
+  pthread_cond_init(&job->wake, NULL);
+#endif
+  if (num_workers <= 0) num_workers = bench_num_cores();
+  if (depth <= 0) depth = 4 * num_workers;
+  if (depth < 2) depth = 2;
+  job->depth = depth;
+  job->slots = calloc(depth, sizeof(pipe_slot_t));
+  threads = malloc((num_workers + 1) * sizeof(*threads));
+  if (!job->slots || !threads || pipe_queue_init(&job->free_q, depth) ||
+      pipe_queue_init(&job->work_q, depth) ||
+      pipe_queue_init(&job->done_q, depth))
+    goto done;
+  for (i = 0; i < depth; i++) {
+    job->slots[i].in = pipe_alloc((size_t)job->chunk_size + CRYPTO_ABYTES);
+    job->slots[i].out = pipe_alloc((size_t)job->chunk_size + CRYPTO_ABYTES);
+    if (!job->slots[i].in || !job->slots[i].out) goto done;
+    pipe_push(&job->free_q, i);
+  }
+
+  /* thread 0 reads, the others encrypt or decrypt */
+  for (n = 0; n <= num_workers; n++) {
+#ifdef _WIN32
+    threads[n] = CreateThread(
+        NULL, 0,
+        (LPTHREAD_START_ROUTINE)(n == 0 ? pipe_reader : pipe_worker), job,
+        0, NULL);
+    if (!threads[n]) break;
+#else
+    if (pthread_create(&threads[n], NULL, n == 0 ? pipe_reader : pipe_worker,
+                       job))
+      break;
+#endif
+  }
+  if (n <= num_workers) pipe_set(job, &job->failed);
+  pipe_writer(job);
+  pipe_set(job, &job->stop);
+#ifdef _WIN32
+  WaitForMultipleObjects(n, threads, TRUE, INFINITE);
+  for (i = 0; i < n; i++) CloseHandle(threads[i]);
+#else
+  for (i = 0; i < n; i++) pthread_join(threads[i], NULL);
+#endif
+  result = LOAD(&job->failed) ? -1 : 0;
+
+done:
+  if (job->slots) {
+    for (i = 0; i < depth; i++) {
+      pipe_free(job->slots[i].in);
+      pipe_free(job->slots[i].out);
+    }
+  }
+  free(job->slots);
+  free(threads);
+  free(job->free_q.cells);
+  free(job->work_q.cells);
+  free(job->done_q.cells);
+#ifdef _WIN32
+  DeleteCriticalSection(&job->lock);
+#else
+  pthread_mutex_destroy(&job->lock);
+  pthread_cond_destroy(&job->wake);
+#endif
+  return result;
+}
+
+int ascon_pipe_encrypt(int in_fd, int out_fd, const unsigned char* k,
+                       const unsigned char* nonce, uint32_t chunk_size,
+                       int variant, int num_workers, int depth) {
+  unsigned char trailer[ASCON_CF_TRAILER_BYTES];
+  pipe_job_t job;
+
+  memset(&job, 0, sizeof(job));
+  if (ascon_cf_header(job.header, nonce, chunk_size, variant) ||
+      ascon_cf_parse(job.header, &job.chunk_size, &job.rate))
+    return -1;
+  job.k = k;
+  job.in_fd = in_fd;
+  job.out_fd = out_fd;
+  if (write_full(out_fd, job.header, ASCON_CF_HEADER_BYTES) ||
+      pipe_run(&job, num_workers, depth) ||
+      ascon_cf_seal_trailer(job.header, k, (uint64_t)job.length, trailer) ||
+      write_full(out_fd, trailer, ASCON_CF_TRAILER_BYTES))
+    return -1;
+  return 0;
+}
+
+int ascon_pipe_decrypt(int in_fd, int out_fd, const unsigned char* k,
+                       int num_workers, int depth) {
+  unsigned char trailer[ASCON_CF_TRAILER_BYTES];
+  pipe_job_t job;
+  int64_t size;
+
+  memset(&job, 0, sizeof(job));
+  job.k = k;
+  job.decrypt = 1;
+  job.in_fd = in_fd;
+  job.out_fd = out_fd;
+  size = lseek(in_fd, 0, SEEK_END);
+  if (size < ASCON_CF_HEADER_BYTES + ASCON_CF_TRAILER_BYTES ||
+      lseek(in_fd, size - ASCON_CF_TRAILER_BYTES, SEEK_SET) < 0 ||
+      read_full(in_fd, trailer, ASCON_CF_TRAILER_BYTES) !=
+          ASCON_CF_TRAILER_BYTES ||
+      lseek(in_fd, 0, SEEK_SET) != 0 ||
+      read_full(in_fd, job.header, ASCON_CF_HEADER_BYTES) !=
+          ASCON_CF_HEADER_BYTES ||
+      ascon_cf_parse(job.header, &job.chunk_size, &job.rate) ||
+      ascon_cf_open_trailer(job.header, k, trailer, &job.expect_length))
+    return -1;
+  job.expect_chunks =
+      (job.expect_length + job.chunk_size - 1) / job.chunk_size;
+  if ((uint64_t)size != ASCON_CF_HEADER_BYTES + job.expect_length +
+                            job.expect_chunks * CRYPTO_ABYTES +
+                            ASCON_CF_TRAILER_BYTES)
+    return -1;
+  return pipe_run(&job, num_workers, depth);
+}
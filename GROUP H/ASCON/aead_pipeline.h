@@ -0,0 +1,33 @@
+#ifndef AEAD_PIPELINE_H_
+#define AEAD_PIPELINE_H_
+
+#include <stdint.h>
+
+/* Streaming file engine for the aead_chunked.h container:
+ *
+ *   reader thread --work queue--> worker threads --done queue--> writer
+ *        ^                                                          |
+ *        +------------------------ free queue ----------------------+
+ *
+ * depth buffer pairs (input and output, page aligned) circulate through
+ * three bounded lock-free queues, so the reader stops when every buffer is
+ * in use (backpressure) and nothing is allocated per chunk. Workers take up
+ * to 4 chunks at a time for the 4-lane engine, and the writer (the calling
+ * thread) puts chunks back into file order. Reading, encryption and writing
+ * overlap, so throughput is bounded by the slowest stage instead of the sum.
+ *
+ * num_workers <= 0 uses one worker per core, depth <= 0 uses 4 buffers per
+ * worker. All functions return 0 on success and -1 on errors. */
+
+/* in_fd is read sequentially to the end, so it may be a pipe */
+int ascon_pipe_encrypt(int in_fd, int out_fd, const unsigned char* k,
+                       const unsigned char* nonce, uint32_t chunk_size,
+                       int variant, int num_workers, int depth);
+
+/* in_fd has to be seekable: the trailer is checked before the first chunk
+ * is read. Plaintext is written only after its chunk authenticated, but a
+ * failure in a later chunk leaves a partial output behind. */
+int ascon_pipe_decrypt(int in_fd, int out_fd, const unsigned char* k,
+                       int num_workers, int depth);
+
+#endif /* AEAD_PIPELINE_H_ */
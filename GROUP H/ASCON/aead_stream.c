@@ -0,0 +1,213 @@
+#include "aead_stream.h"
+
+#include <string.h>
+
+#include "ascon_aead.h"
+
+#define PHASE_AD 0
+#define PHASE_AD_SEEN 1
+#define PHASE_MSG 2
+#define PHASE_DONE 3
+
+int ascon_aead_init(ascon_aead_ctx_t* ctx, int variant, const uint8_t* k,
+                    const uint8_t* npub) {
+  ctx->variant = variant;
+  ctx->pos = 0;
+  ctx->phase = PHASE_AD;
+  if (variant == ASCON_AEAD_80PQ) {
+    ctx->rate = ASCON_128_RATE;
+    ctx->K0 = LOADBYTES(k, 4) >> 32;
+    ctx->K1 = LOADBYTES(k + 4, 8);
+    ctx->K2 = LOADBYTES(k + 12, 8);
+    ascon80pq_initaead(&ctx->s, ctx->K0, ctx->K1, ctx->K2, npub);
+    return 0;
+  }
+  if (variant != ASCON_AEAD_128 && variant != ASCON_AEAD_128A) {
+    ctx->phase = PHASE_DONE;
+    return -1;
+  }
+  ctx->rate = variant == ASCON_AEAD_128A ? ASCON_128A_RATE : ASCON_128_RATE;
+  ctx->K0 = LOADBYTES(k, 8);
+  ctx->K1 = LOADBYTES(k + 8, 8);
+  ctx->K2 = 0;
+  ascon_initaead(&ctx->s,
+                 variant == ASCON_AEAD_128A ? ASCON_128A_IV : ASCON_128_IV,
+                 ctx->K0, ctx->K1, npub);
+  return 0;
+}
+
+/* Bytes are xored into the rate at ctx->pos, one word-aligned piece at a
+ * time, so a call can stop anywhere inside a block. A block is permuted as
+ * soon as it is full: the final (padded) block is always a partial one,
+ * exactly as in the one-shot code. */
+
+/* largest piece starting at pos that stays within one state word */
+static inline int piece(const ascon_aead_ctx_t* ctx, size_t len) {
+  int n = 8 - ctx->pos % 8;
+  return len < (size_t)n ? (int)len : n;
+}
+
+static inline void advance(ascon_aead_ctx_t* ctx, int n, const char* text) {
+  (void)text; /* only printed with ASCON_PRINT_STATE */
+  ctx->pos += n;
+  if (ctx->pos == ctx->rate) {
+    printstate(text, &ctx->s);
+    ascon_pb(&ctx->s, ctx->rate);
+    ctx->pos = 0;
+  }
+}
+
+static inline void pad(ascon_aead_ctx_t* ctx, const char* text) {
+  (void)text;
+  ctx->s.x[ctx->pos / 8] ^= PAD(ctx->pos % 8);
+  printstate(text, &ctx->s);
+}
+
+/* close the associated data and add the domain separation bit */
+static void start_message(ascon_aead_ctx_t* ctx) {
+  ASCON_TRACE_ENTER(ASCON_PHASE_AD, 0);
+  if (ctx->phase == PHASE_AD_SEEN) {
+    pad(ctx, "pad adata");
+    ascon_pb(&ctx->s, ctx->rate);
+    ctx->pos = 0;
+  }
+  ctx->s.x[4] ^= DSEP();
+  printstate("domain separation", &ctx->s);
+  ctx->phase = PHASE_MSG;
+  ASCON_TRACE_LEAVE();
+}
+
+int ascon_aead_update_ad(ascon_aead_ctx_t* ctx, const uint8_t* ad,
+                         size_t len) {
+  if (ctx->phase > PHASE_AD_SEEN) return -1;
+  if (!len) return 0;
+  ctx->phase = PHASE_AD_SEEN;
+  ASCON_TRACE_ENTER(ASCON_PHASE_AD, len);
+  while (len) {
+    int n = piece(ctx, len);
+    ctx->s.x[ctx->pos / 8] ^= LOADBYTES(ad, n) >> (8 * (ctx->pos % 8));
+    advance(ctx, n, "absorb adata");
+    ad += n;
+    len -= n;
+  }
+  ASCON_TRACE_LEAVE();
+  return 0;
+}
+
+int ascon_aead_encrypt_update(ascon_aead_ctx_t* ctx, uint8_t* c,
+                              const uint8_t* m, size_t len) {
+  if (ctx->phase == PHASE_DONE) return -1;
+  if (ctx->phase != PHASE_MSG) start_message(ctx);
+  ASCON_TRACE_ENTER(ASCON_PHASE_MSG, len);
+  while (len) {
+    int n = piece(ctx, len);
+    int shift = 8 * (ctx->pos % 8);
+    uint64_t* px = &ctx->s.x[ctx->pos / 8];
+    *px ^= LOADBYTES(m, n) >> shift;
+    STOREBYTES(c, *px << shift, n);
+    advance(ctx, n, "absorb plaintext");
+    m += n;
+    c += n;
+    len -= n;
+  }
+  ASCON_TRACE_LEAVE();
+  return 0;
+}
+
+int ascon_aead_decrypt_update(ascon_aead_ctx_t* ctx, uint8_t* m,
+                              const uint8_t* c, size_t len) {
+  if (ctx->phase == PHASE_DONE) return -1;
+  if (ctx->phase != PHASE_MSG) start_message(ctx);
+  ASCON_TRACE_ENTER(ASCON_PHASE_MSG, len);
+  while (len) {
+    int n = piece(ctx, len);
+    int shift = 8 * (ctx->pos % 8);
+    uint64_t* px = &ctx->s.x[ctx->pos / 8];
+    uint64_t c0 = LOADBYTES(c, n) >> shift;
+    uint64_t mask = ~CLEARBYTES(~(uint64_t)0, n) >> shift;
+    STOREBYTES(m, (*px ^ c0) << shift, n);
+    *px = (*px & ~mask) | c0;
+    advance(ctx, n, "insert ciphertext");
+    m += n;
+    c += n;
+    len -= n;
+  }
+  ASCON_TRACE_LEAVE();
+  return 0;
+}
+
+static void finalize(ascon_aead_ctx_t* ctx, const char* text) {
+  if (ctx->phase != PHASE_MSG) start_message(ctx);
+  pad(ctx, text);
+  if (ctx->variant == ASCON_AEAD_80PQ)
+    ascon80pq_final(&ctx->s, ctx->K0, ctx->K1, ctx->K2);
+  else
+    ascon_final(&ctx->s, ctx->K0, ctx->K1, ctx->rate);
+  ctx->phase = PHASE_DONE;
+}
+
+int ascon_aead_encrypt_final(ascon_aead_ctx_t* ctx, uint8_t* tag) {
+  if (ctx->phase == PHASE_DONE) return -1;
+  finalize(ctx, "pad plaintext");
+  STOREBYTES(tag, ctx->s.x[3], 8);
+  STOREBYTES(tag + 8, ctx->s.x[4], 8);
+  return 0;
+}
+
+int ascon_aead_decrypt_final(ascon_aead_ctx_t* ctx, const uint8_t* tag) {
+  if (ctx->phase == PHASE_DONE) return -1;
+  finalize(ctx, "pad ciphertext");
+  return ascon_verify(tag, &ctx->s);
+}
+
+static int absorb_iov(ascon_aead_ctx_t* ctx, const ascon_iovec_t* ad,
+                      int adcnt) {
+  int i;
+  for (i = 0; i < adcnt; i++)
+    if (ascon_aead_update_ad(ctx, (const uint8_t*)ad[i].base, ad[i].len))
+      return -1;
+  return 0;
+}
+
+/* out[i] has to match in[i] in length; checked before anything is written */
+static int check_iov(const ascon_iovec_t* in, const ascon_iovec_t* out,
+                     int cnt) {
+  int i;
+  for (i = 0; i < cnt; i++)
+    if (out[i].len != in[i].len) return -1;
+  return 0;
+}
+
+int ascon_aead_encryptv(int variant, const uint8_t* k, const uint8_t* npub,
+                        const ascon_iovec_t* ad, int adcnt,
+                        const ascon_iovec_t* in, const ascon_iovec_t* out,
+                        int cnt, uint8_t* tag) {
+  ascon_aead_ctx_t ctx;
+  int i;
+  if (check_iov(in, out, cnt) || ascon_aead_init(&ctx, variant, k, npub) ||
+      absorb_iov(&ctx, ad, adcnt))
+    return -1;
+  for (i = 0; i < cnt; i++)
+    ascon_aead_encrypt_update(&ctx, (uint8_t*)out[i].base,
+                              (const uint8_t*)in[i].base, in[i].len);
+  return ascon_aead_encrypt_final(&ctx, tag);
+}
+
+int ascon_aead_decryptv(int variant, const uint8_t* k, const uint8_t* npub,
+                        const ascon_iovec_t* ad, int adcnt,
+                        const ascon_iovec_t* in, const ascon_iovec_t* out,
+                        int cnt, const uint8_t* tag) {
+  ascon_aead_ctx_t ctx;
+  int i, result;
+  if (check_iov(in, out, cnt) || ascon_aead_init(&ctx, variant, k, npub) ||
+      absorb_iov(&ctx, ad, adcnt))
+    return -1;
+  for (i = 0; i < cnt; i++)
+    ascon_aead_decrypt_update(&ctx, (uint8_t*)out[i].base,
+                              (const uint8_t*)in[i].base, in[i].len);
+  result = ascon_aead_decrypt_final(&ctx, tag);
+  /* do not hand out unauthenticated plaintext */
+  if (result)
+    for (i = 0; i < cnt; i++) memset(out[i].base, 0, out[i].len);
+  return result;
+}
@@ -0,0 +1,70 @@
+#ifndef AEAD_STREAM_H_
+#define AEAD_STREAM_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ascon.h"
+
+#define ASCON_AEAD_128 0
+#define ASCON_AEAD_128A 1
+#define ASCON_AEAD_80PQ 2
+
+/* incremental Ascon-128/128a/80pq encryption or decryption */
+typedef struct {
+  ascon_state_t s;
+  uint64_t K0, K1, K2;
+  int variant;
+  int rate;
+  int pos;   /* bytes of the current rate block already absorbed */
+  int phase; /* 0 adata, 1 adata seen, 2 message, 3 finalized */
+} ascon_aead_ctx_t;
+
+/* k is ASCON_80PQ_KEYBYTES for Ascon-80pq and CRYPTO_KEYBYTES otherwise,
+ * npub is CRYPTO_NPUBBYTES. Returns -1 for an unknown variant. */
+int ascon_aead_init(ascon_aead_ctx_t* ctx, int variant, const uint8_t* k,
+                    const uint8_t* npub);
+
+/* associated data, any number of calls and lengths, all before the first
+ * message call. Returns -1 once message data has been processed. */
+int ascon_aead_update_ad(ascon_aead_ctx_t* ctx, const uint8_t* ad,
+                         size_t len);
+
+/* Encrypt or decrypt len bytes; exactly len bytes are written to the output
+ * on every call, no data is held back between calls. The output may be the
+ * input (in == out). Decrypted bytes are not authentic until
+ * ascon_aead_decrypt_final() returned 0. */
+int ascon_aead_encrypt_update(ascon_aead_ctx_t* ctx, uint8_t* c,
+                              const uint8_t* m, size_t len);
+int ascon_aead_decrypt_update(ascon_aead_ctx_t* ctx, uint8_t* m,
+                              const uint8_t* c, size_t len);
+
+/* write the CRYPTO_ABYTES tag, or compare it in constant time (0 if valid,
+ * -1 otherwise); the context has to be initialized again afterwards */
+int ascon_aead_encrypt_final(ascon_aead_ctx_t* ctx, uint8_t* tag);
+int ascon_aead_decrypt_final(ascon_aead_ctx_t* ctx, const uint8_t* tag);
+
+/* one fragment of a scatter-gather buffer, like struct iovec */
+typedef struct {
+  void* base;
+  size_t len;
+} ascon_iovec_t;
+
+/* Single-call encryption and decryption of fragmented data: the AD is the
+ * concatenation of the adcnt fragments of ad, the message that of the cnt
+ * fragments of in. out[i] receives exactly in[i].len bytes; if any out[i].len
+ * differs, -1 is returned before anything is written. For in place operation
+ * out[i].base == in[i].base (out may be in itself); otherwise no output
+ * fragment may overlap any input fragment, since a later input fragment
+ * would be overwritten before it is read. The tag is separate. If
+ * decryption fails, every output fragment is cleared. */
+int ascon_aead_encryptv(int variant, const uint8_t* k, const uint8_t* npub,
+                        const ascon_iovec_t* ad, int adcnt,
+                        const ascon_iovec_t* in, const ascon_iovec_t* out,
+                        int cnt, uint8_t* tag);
+int ascon_aead_decryptv(int variant, const uint8_t* k, const uint8_t* npub,
+                        const ascon_iovec_t* ad, int adcnt,
+                        const ascon_iovec_t* in, const ascon_iovec_t* out,
+                        int cnt, const uint8_t* tag);
+
+#endif /* AEAD_STREAM_H_ */
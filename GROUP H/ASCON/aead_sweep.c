@@ -0,0 +1,263 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ascon_aead.h"
+#include "bench.h"
+#include "rapl.h"
+#include "testdata.h"
+
+#define MAX_MESSAGE_SIZE (16 * 1024 * 1024) // 16 MB
+#define MAX_AD_SIZE 64
+#define MIN_RUN_SECONDS 0.01                // small messages are repeated until a run takes this long
+#define MIN_RAPL_RUN_SECONDS 0.1            // with energy, so the 1 ms counter steps stay below 1%
+#define REPETITIONS 7                       // the median run is reported
+
+static const unsigned long long message_sizes[] = {
+    0, 1, 8, 16, 32, 64, 128, 256, 512, 1024, 4096, 16384, 65536,
+    256 * 1024, 1024 * 1024, 4 * 1024 * 1024, 16 * 1024 * 1024
+};
+static const unsigned long long ad_sizes[] = { 0, 8, 16, 32, 64 };
+
+#define NUM_MESSAGE_SIZES ((int)(sizeof(message_sizes) / sizeof(message_sizes[0])))
+#define NUM_AD_SIZES ((int)(sizeof(ad_sizes) / sizeof(ad_sizes[0])))
+
+typedef struct {
+    const char* name;
+    int (*encrypt)(unsigned char* c, unsigned long long* clen,
+        const unsigned char* m, unsigned long long mlen,
+        const unsigned char* ad, unsigned long long adlen,
+        const unsigned char* nsec, const unsigned char* npub,
+        const unsigned char* k);
+    int (*decrypt)(unsigned char* m, unsigned long long* mlen,
+        unsigned char* nsec, const unsigned char* c,
+        unsigned long long clen, const unsigned char* ad,
+        unsigned long long adlen, const unsigned char* npub,
+        const unsigned char* k);
+} AeadVariant;
+
+static const AeadVariant variants[] = {
+    { "Ascon-128", ascon128_aead_encrypt, ascon128_aead_decrypt },
+    { "Ascon-128a", ascon128a_aead_encrypt, ascon128a_aead_decrypt },
+    { "Ascon-80pq", ascon80pq_aead_encrypt, ascon80pq_aead_decrypt },
+};
+
+#define NUM_VARIANTS ((int)(sizeof(variants) / sizeof(variants[0])))
+
+typedef struct {
+    unsigned long long calls;
+    double seconds;
+    double cycles; // 0 if unknown
+    double energy_uj; // above idle, -1 if unknown
+} Measurement;
+
+typedef struct {
+    unsigned char key[ASCON_80PQ_KEYBYTES];
+    unsigned char nonce[CRYPTO_NPUBBYTES];
+    unsigned char ad[MAX_AD_SIZE];
+    unsigned char* plaintext;
+    unsigned char* ciphertext;
+    unsigned char* output;
+    double ghz; // > 0: cycles = time x GHz instead of the timestamp counter
+    int failures;
+    const rapl_t* rapl; // NULL: no energy figures
+    double min_run_seconds;
+} SweepContext;
+
+int compare_measurements(const void* a, const void* b) {
+    double x = ((const Measurement*)a)->seconds, y = ((const Measurement*)b)->seconds;
+    return x < y ? -1 : x > y;
+}
+
+// calls x one encryption or decryption of the same message
+Measurement measure(SweepContext* ctx, const AeadVariant* variant, int is_encryption,
+                    unsigned long long message_size, unsigned long long ad_size, unsigned long long calls) {
+    Measurement m = { calls, 0, 0, -1 };
+    unsigned long long len;
+    int failed = 0;
+    uint64_t energy_before, energy_after;
+    int have_energy = ctx->rapl && rapl_read(ctx->rapl, &energy_before) == 0;
+
+    double start = bench_seconds();
+    uint64_t start_cycles = bench_cycles();
+    for (unsigned long long i = 0; i < calls; i++) {
+        if (is_encryption) {
+            variant->encrypt(ctx->output, &len, ctx->plaintext, message_size, ctx->ad, ad_size, NULL, ctx->nonce, ctx->key);
+        } else {
+            failed |= variant->decrypt(ctx->output, &len, NULL, ctx->ciphertext, message_size + CRYPTO_ABYTES,
+                                       ctx->ad, ad_size, ctx->nonce, ctx->key);
+        }
+    }
+    uint64_t end_cycles = bench_cycles();
+    m.seconds = bench_seconds() - start;
+    if (have_energy && rapl_read(ctx->rapl, &energy_after) == 0) {
+        m.energy_uj = rapl_active_uj(ctx->rapl, energy_before, energy_after, m.seconds);
+    }
+
+    if (ctx->ghz > 0) {
+        m.cycles = m.seconds * ctx->ghz * 1e9;
+    } else if (bench_cycles_supported()) {
+        m.cycles = (double)(end_cycles - start_cycles);
+    }
+    ctx->failures += failed != 0;
+    return m;
+}
+
+// Doubles the calls per run until a run takes min_run_seconds (which also warms up caches and
+// clocks), then returns the median of REPETITIONS runs
+Measurement measure_median(SweepContext* ctx, const AeadVariant* variant, int is_encryption,
+                           unsigned long long message_size, unsigned long long ad_size) {
+    Measurement runs[REPETITIONS];
+    unsigned long long calls = 1;
+
+    if (!is_encryption) {
+        unsigned long long clen;
+        variant->encrypt(ctx->ciphertext, &clen, ctx->plaintext, message_size, ctx->ad, ad_size, NULL, ctx->nonce, ctx->key);
+    }
+    while (measure(ctx, variant, is_encryption, message_size, ad_size, calls).seconds < ctx->min_run_seconds) {
+        calls *= 2;
+    }
+    for (int r = 0; r < REPETITIONS; r++) {
+        runs[r] = measure(ctx, variant, is_encryption, message_size, ad_size, calls);
+    }
+    qsort(runs, REPETITIONS, sizeof(Measurement), compare_measurements);
+    return runs[REPETITIONS / 2];
+}
+
+void print_size(char* out, unsigned long long bytes) {
+    if (bytes >= 1024 * 1024 && bytes % (1024 * 1024) == 0) {
+        sprintf(out, "%llu MB", bytes / (1024 * 1024));
+    } else if (bytes >= 1024 && bytes % 1024 == 0) {
+        sprintf(out, "%llu KB", bytes / 1024);
+    } else {
+        sprintf(out, "%llu B", bytes);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <csv_file> [variant: 0=Ascon-128, 1=Ascon-128a, 2=Ascon-80pq, -1=all (default)] [max_message_size_in_bytes] [platform label] [cpu_GHz]\n", argv[0]);
+        fprintf(stderr, "cpu_GHz converts time to cycles; without it cycles come from the CPU timestamp counter (x86 only)\n");
+        return 1;
+    }
+
+    const char* csv_path = argv[1];
+    int variant = argc > 2 ? atoi(argv[2]) : -1;
+    unsigned long long max_message_size = argc > 3 ? strtoull(argv[3], NULL, 10) : MAX_MESSAGE_SIZE;
+    const char* platform = argc > 4 ? argv[4] : "This machine";
+    SweepContext ctx = { .ghz = argc > 5 ? atof(argv[5]) : 0 };
+    if (variant < -1 || variant >= NUM_VARIANTS) {
+        fprintf(stderr, "Unknown variant %d\n", variant);
+        return 1;
+    }
+    if (max_message_size > MAX_MESSAGE_SIZE) {
+        max_message_size = MAX_MESSAGE_SIZE;
+    }
+
+    ctx.plaintext = malloc(max_message_size + CRYPTO_ABYTES);
+    ctx.ciphertext = malloc(max_message_size + CRYPTO_ABYTES);
+    ctx.output = malloc(max_message_size + CRYPTO_ABYTES);
+    if (!ctx.plaintext || !ctx.ciphertext || !ctx.output) {
+        perror("Memory allocation failed");
+        return 1;
+    }
+    testdata_stream_t message;
+    testdata_stream(&message, testdata_seed(), TESTDATA_MESSAGE);
+    testdata_fill_parallel(&message, ctx.plaintext, max_message_size + CRYPTO_ABYTES, bench_num_cores());
+    testdata_bytes(TESTDATA_KEY, ctx.key, ASCON_80PQ_KEYBYTES);
+    testdata_bytes(TESTDATA_NONCE, ctx.nonce, CRYPTO_NPUBBYTES);
+    testdata_bytes(TESTDATA_AD, ctx.ad, MAX_AD_SIZE);
+
+    // Energy above the idle power of the package, with longer runs
+    rapl_t rapl;
+    ctx.min_run_seconds = MIN_RUN_SECONDS;
+    if (rapl_open(&rapl) == 0 && rapl_measure_idle(&rapl, RAPL_IDLE_MS) == 0) {
+        ctx.rapl = &rapl;
+        ctx.min_run_seconds = MIN_RAPL_RUN_SECONDS;
+        printf("Energy: RAPL %s, idle %.0f mW subtracted\n", rapl.zone, rapl.idle_mw);
+    } else {
+        printf("Energy: no RAPL access, no nJ/byte figures\n");
+    }
+
+    FILE* csv = fopen(csv_path, "w");
+    if (!csv) {
+        perror(csv_path);
+        return 1;
+    }
+    // One row per variant, operation, message and AD size; Time and DATA are those of the median run
+    fprintf(csv, "Platform,Operation,DATA (MB),Threads,Time (s),Throughput (MB/s),"
+                 "Message (B),AD (B),Calls,Latency (ns/call),Cycles/call,Cycles/byte,Energy (nJ/byte),Variant\n");
+
+    int have_cycles = ctx.ghz > 0 || bench_cycles_supported();
+    printf("%-10s %-7s %8s %5s %14s %14s %12s", "Variant", "Op", "Message", "AD",
+        "ns/call", "cycles/call", "cycles/byte");
+    printf(ctx.rapl ? " %10s\n" : "\n", "nJ/byte");
+
+    for (int v = 0; v < NUM_VARIANTS; v++) {
+        if (variant != -1 && variant != v) {
+            continue;
+        }
+        for (int op = 0; op < 2; op++) {
+            int is_encryption = op == 0;
+            for (int s = 0; s < NUM_MESSAGE_SIZES && message_sizes[s] <= max_message_size; s++) {
+                for (int a = 0; a < NUM_AD_SIZES; a++) {
+                    unsigned long long message_size = message_sizes[s];
+                    unsigned long long ad_size = ad_sizes[a];
+                    Measurement m = measure_median(&ctx, &variants[v], is_encryption, message_size, ad_size);
+
+                    double data_mb = (double)(m.calls * message_size) / (1024 * 1024);
+                    double latency_ns = m.seconds * 1e9 / m.calls;
+                    double cycles_per_call = m.cycles / m.calls;
+                    int have_energy = m.energy_uj >= 0 && message_size;
+                    double nj_per_byte = have_energy ? m.energy_uj * 1e3 / ((double)m.calls * message_size) : 0;
+                    char size_text[32];
+                    print_size(size_text, message_size);
+
+                    fprintf(csv, "\"%s\",%s,%f,1,%f,%f,%llu,%llu,%llu,%f,",
+                        platform, is_encryption ? "Encrypt" : "Decrypt", data_mb, m.seconds, m.seconds > 0 ? data_mb / m.seconds : 0,
+                        message_size, ad_size, m.calls, latency_ns);
+                    if (have_cycles) {
+                        fprintf(csv, "%f,", cycles_per_call);
+                        if (message_size) {
+                            fprintf(csv, "%f", cycles_per_call / message_size);
+                        }
+                    } else {
+                        fprintf(csv, ",");
+                    }
+                    fprintf(csv, ",");
+                    if (have_energy) {
+                        fprintf(csv, "%f", nj_per_byte);
+                    }
+                    fprintf(csv, ",%s\n", variants[v].name);
+
+                    printf("%-10s %-7s %8s %5llu %14.1f ", variants[v].name, is_encryption ? "encrypt" : "decrypt",
+                        size_text, ad_size, latency_ns);
+                    if (have_cycles) {
+                        printf("%14.0f", cycles_per_call);
+                        if (message_size) {
+                            printf(" %12.2f", cycles_per_call / message_size);
+                        }
+                    }
+                    if (have_energy) {
+                        if (!have_cycles) {
+                            printf("%14s %12s", "", "");
+                        }
+                        printf(" %10.3f", nj_per_byte);
+                    }
+                    printf("\n");
+                }
+            }
+        }
+    }
+
+    fclose(csv);
+    if (ctx.failures) {
+        printf("Warning: %d decryption measurements failed to verify\n", ctx.failures);
+    }
+    printf("Results written to %s\n", csv_path);
+    free(ctx.plaintext);
+    free(ctx.ciphertext);
+    free(ctx.output);
+    return 0;
+}
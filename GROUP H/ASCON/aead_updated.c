@@ -2,18 +2,18 @@
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
-#include <time.h>
-
-#ifdef _WIN32
-#include <windows.h>
-#else
-#include <pthread.h>
-#endif
 
 #include "api.h"
+#include "aead_avx2.h"
+#include "bench.h"
 #include "ascon.h"
+#include "ascon_aead.h"
+#include "nonce.h"
 #include "permutations.h"
 #include "printstate.h"
+#include "rapl.h"
+#include "testdata.h"
+#include "trace.h"
 #include "word.h"
 
 int crypto_aead_encrypt(unsigned char* c, unsigned long long* clen,
@@ -33,6 +33,7 @@ int crypto_aead_encrypt(unsigned char* c, unsigned long long* clen,
     const uint64_t N1 = LOADBYTES(npub + 8, 8);
 
     /* initialize */
+    ASCON_TRACE_ENTER(ASCON_PHASE_INIT, 0);
     ascon_state_t s;
     s.x[0] = ASCON_128_IV;
     s.x[1] = K0;
@@ -44,7 +45,9 @@ int crypto_aead_encrypt(unsigned char* c, unsigned long long* clen,
     s.x[3] ^= K0;
     s.x[4] ^= K1;
     printstate("init 2nd key xor", &s);
+    ASCON_TRACE_LEAVE();
 
+    ASCON_TRACE_ENTER(ASCON_PHASE_AD, adlen);
     if (adlen) {
         /* full associated data blocks */
         while (adlen >= ASCON_128_RATE) {
@@ -63,8 +66,10 @@ int crypto_aead_encrypt(unsigned char* c, unsigned long long* clen,
     /* domain separation */
     s.x[4] ^= DSEP();
     printstate("domain separation", &s);
+    ASCON_TRACE_LEAVE();
 
     /* full plaintext blocks */
+    ASCON_TRACE_ENTER(ASCON_PHASE_MSG, mlen);
     while (mlen >= ASCON_128_RATE) {
         s.x[0] ^= LOADBYTES(m, 8);
         STOREBYTES(c, s.x[0], 8);
@@ -80,8 +85,10 @@ int crypto_aead_encrypt(unsigned char* c, unsigned long long* clen,
     s.x[0] ^= PAD(mlen);
     c += mlen;
     printstate("pad plaintext", &s);
+    ASCON_TRACE_LEAVE();
 
     /* finalize */
+    ASCON_TRACE_ENTER(ASCON_PHASE_FINAL, 0);
     s.x[1] ^= K0;
     s.x[2] ^= K1;
     printstate("final 1st key xor", &s);
@@ -89,6 +96,7 @@ int crypto_aead_encrypt(unsigned char* c, unsigned long long* clen,
     s.x[3] ^= K0;
     s.x[4] ^= K1;
     printstate("final 2nd key xor", &s);
+    ASCON_TRACE_LEAVE();
 
     /* get tag */
     STOREBYTES(c, s.x[3], 8);
@@ -116,6 +124,7 @@ int crypto_aead_decrypt(unsigned char* m, unsigned long long* mlen,
     const uint64_t N1 = LOADBYTES(npub + 8, 8);
 
     /* initialize */
+    ASCON_TRACE_ENTER(ASCON_PHASE_INIT, 0);
     ascon_state_t s;
     s.x[0] = ASCON_128_IV;
     s.x[1] = K0;
@@ -127,7 +136,9 @@ int crypto_aead_decrypt(unsigned char* m, unsigned long long* mlen,
     s.x[3] ^= K0;
     s.x[4] ^= K1;
     printstate("init 2nd key xor", &s);
+    ASCON_TRACE_LEAVE();
 
+    ASCON_TRACE_ENTER(ASCON_PHASE_AD, adlen);
     if (adlen) {
         /* full associated data blocks */
         while (adlen >= ASCON_128_RATE) {
@@ -146,9 +157,11 @@ int crypto_aead_decrypt(unsigned char* m, unsigned long long* mlen,
     /* domain separation */
     s.x[4] ^= DSEP();
     printstate("domain separation", &s);
+    ASCON_TRACE_LEAVE();
 
     /* full ciphertext blocks */
     clen -= CRYPTO_ABYTES;
+    ASCON_TRACE_ENTER(ASCON_PHASE_MSG, clen);
     while (clen >= ASCON_128_RATE) {
         uint64_t c0 = LOADBYTES(c, 8);
         STOREBYTES(m, s.x[0] ^ c0, 8);
@@ -167,8 +180,10 @@ int crypto_aead_decrypt(unsigned char* m, unsigned long long* mlen,
     s.x[0] ^= PAD(clen);
     c += clen;
     printstate("pad ciphertext", &s);
+    ASCON_TRACE_LEAVE();
 
     /* finalize */
+    ASCON_TRACE_ENTER(ASCON_PHASE_FINAL, 0);
     s.x[1] ^= K0;
     s.x[2] ^= K1;
     printstate("final 1st key xor", &s);
@@ -176,6 +191,7 @@ int crypto_aead_decrypt(unsigned char* m, unsigned long long* mlen,
     s.x[3] ^= K0;
     s.x[4] ^= K1;
     printstate("final 2nd key xor", &s);
+    ASCON_TRACE_LEAVE();
 
     /* get tag */
     uint8_t t[16];
@@ -192,126 +208,286 @@ int crypto_aead_decrypt(unsigned char* m, unsigned long long* mlen,
 }
 
 
-#define KEY_SIZE 16   // ASCON key size
-#define NONCE_SIZE 12 // ASCON nonce size
-#define CHUNK_SIZE (1 * 1024 * 1024) // 1 MB
+#define KEY_SIZE ASCON_80PQ_KEYBYTES // Largest ASCON key size (Ascon-80pq)
+#define NONCE_SIZE CRYPTO_NPUBBYTES // crypto_aead_* read 16 bytes of nonce
+#define CHUNK_SIZE (1 * 1024 * 1024) // 1 MB, the unit of work and of the latency figures
+#define WARMUP_CHUNKS 2              // untimed chunks per thread before the measurement
 
 typedef struct {
-    unsigned char* input_data;
-    unsigned char* output_data;
-    unsigned char* key;
-    unsigned char* nonce;
-    int thread_num;
-    unsigned long long iterations;
+    const char* name;
+    int (*encrypt)(unsigned char* c, unsigned long long* clen,
+        const unsigned char* m, unsigned long long mlen,
+        const unsigned char* ad, unsigned long long adlen,
+        const unsigned char* nsec, const unsigned char* npub,
+        const unsigned char* k);
+    int (*decrypt)(unsigned char* m, unsigned long long* mlen,
+        unsigned char* nsec, const unsigned char* c,
+        unsigned long long clen, const unsigned char* ad,
+        unsigned long long adlen, const unsigned char* npub,
+        const unsigned char* k);
+    int x4_rate; // nonzero: 4 messages per call through the AVX2 engine (encrypt only prepares test data)
+} AeadVariant;
+
+static const AeadVariant variants[] = {
+    { "Ascon-128", crypto_aead_encrypt, crypto_aead_decrypt, 0 },
+    { "Ascon-128a", ascon128a_aead_encrypt, ascon128a_aead_decrypt, 0 },
+    { "Ascon-80pq", ascon80pq_aead_encrypt, ascon80pq_aead_decrypt, 0 },
+    { "Ascon-128 AVX2x4", crypto_aead_encrypt, crypto_aead_decrypt, ASCON_128_RATE },
+    { "Ascon-128a AVX2x4", ascon128a_aead_encrypt, ascon128a_aead_decrypt, ASCON_128A_RATE },
+};
+
+#define NUM_VARIANTS ((int)(sizeof(variants) / sizeof(variants[0])))
+
+// Shared, read-only while the threads run
+typedef struct {
+    const AeadVariant* variant;
+    int is_encryption;
+    unsigned char key[KEY_SIZE];
+    unsigned char nonce[NONCE_SIZE]; // nonce of the prepared ciphertexts (decryption)
+    ascon_nonce_mgr_t nonce_mgr;     // fresh nonce for every encryption
+    unsigned long long message_size;
+    unsigned long long last_message_size; // total_size need not be a multiple of message_size
+    unsigned long long total_messages;
+    unsigned long long messages_per_chunk;
+    unsigned long long slot_size;    // message_size + CRYPTO_ABYTES
+    struct ThreadData* threads;      // one per thread, indexed like bench_thread_t
+    rapl_t* rapl;                    // NULL: no energy figures
+    uint64_t energy_before;          // set by thread 0 at the common start (thread_start)
+    double energy_start;             // 0 if that reading failed
+} Benchmark;
+
+// Per thread; the padding keeps the nonce counters of two threads off the same cache line
+typedef struct ThreadData {
+    ascon_nonce_ctx_t nonces;
+    unsigned char lane_nonce[ASCON_X4_LANES][NONCE_SIZE];
+    unsigned long long failures;
+#ifdef ASCON_TRACE
+    ascon_trace_counts_t trace; // timed units only
+#endif
+    char pad[BENCH_CACHE_LINE];
 } ThreadData;
 
-void generate_random_key(unsigned char* key) {
-    for (size_t i = 0; i < KEY_SIZE; i++) {
-        key[i] = rand() % 256;
+
+// Buffers hold messages_per_chunk slots of slot_size bytes plus one slot for the last, shorter
+// message. Message i of a chunk always uses slot i, so every chunk touches the same
+// thread-local memory.
+void message_slot(const Benchmark* bench, bench_thread_t* t, unsigned long long message, unsigned long long i,
+                  const unsigned char** in, unsigned char** out, unsigned long long* len) {
+    if (message == bench->total_messages - 1) {
+        i = bench->messages_per_chunk;
+        *len = bench->last_message_size;
+    } else {
+        *len = bench->message_size;
     }
+    *in = t->in + i * bench->slot_size;
+    *out = t->out + i * bench->slot_size;
 }
 
-void generate_random_nonce(unsigned char* nonce) {
-    for (size_t i = 0; i < NONCE_SIZE; i++) {
-        nonce[i] = rand() % 256;
+// Runs on the pinned thread, so the pages of its buffers are local to its core
+int setup_thread(bench_thread_t* t) {
+    Benchmark* bench = (Benchmark*)t->config->arg;
+    ThreadData* data = &bench->threads[t->index];
+    unsigned long long slots = bench->messages_per_chunk + 1;
+    testdata_stream_t stream;
+
+    t->user = data;
+    data->failures = 0;
+    ascon_nonce_thread_init(&data->nonces, &bench->nonce_mgr);
+    // Same input for the same thread on every run and platform (TESTDATA_SEED changes it)
+    testdata_stream(&stream, testdata_seed(), TESTDATA_THREAD(t->index));
+    testdata_fill(&stream, 0, t->in, slots * bench->slot_size);
+    if (bench->is_encryption) {
+        return 0;
+    }
+
+    // Decryption gets valid ciphertexts, otherwise it measures the failure path
+    for (unsigned long long i = 0; i < slots; i++) {
+        unsigned long long len = i < bench->messages_per_chunk ? bench->message_size : bench->last_message_size;
+        unsigned long long clen;
+        unsigned char* slot = t->in + i * bench->slot_size;
+        memcpy(t->out, slot, len);
+        bench->variant->encrypt(slot, &clen, t->out, len, NULL, 0, NULL, bench->nonce, bench->key);
     }
+    return 0;
 }
 
-void* encrypt_chunk(void* args) {
-    ThreadData* data = (ThreadData*)args;
+#ifdef ASCON_TRACE
+// Setup and warmup are not traced
+void trace_stop(bench_thread_t* t) {
+    ((ThreadData*)t->user)->trace = ascon_trace_get()->counts;
+}
+#endif
 
-    unsigned long long ciphertext_len = 0;
-    for (unsigned long long i = 0; i < data->iterations; i++) {
-        crypto_aead_encrypt(data->output_data, &ciphertext_len, data->input_data, CHUNK_SIZE, NULL, 0, NULL, data->nonce, data->key);
+// Right before the first timed unit; thread 0 also reads the energy counter there, so the
+// reading covers the same interval as the wall time
+void thread_start(bench_thread_t* t) {
+    Benchmark* bench = (Benchmark*)t->config->arg;
+#ifdef ASCON_TRACE
+    ascon_trace_reset();
+#endif
+    if (t->index == 0 && bench->rapl && rapl_read(bench->rapl, &bench->energy_before) == 0) {
+        bench->energy_start = bench_seconds();
     }
-    return NULL;
 }
 
-void* decrypt_chunk(void* args) {
-    ThreadData* data = (ThreadData*)args;
-
-    unsigned long long plaintext_len = 0;
-    for (unsigned long long i = 0; i < data->iterations; i++) {
-        crypto_aead_decrypt(data->output_data, &plaintext_len, NULL, data->input_data, CHUNK_SIZE, NULL, 0, data->nonce, data->key);
+// One group of up to ASCON_X4_LANES messages through the 4-lane engine
+unsigned long long x4_group(const Benchmark* bench, bench_thread_t* t, unsigned long long first, unsigned long long i,
+                            int nlanes) {
+    ThreadData* data = (ThreadData*)t->user;
+    ascon_lane_t lanes[ASCON_X4_LANES];
+    unsigned long long bytes = 0;
+
+    for (int l = 0; l < nlanes; l++) {
+        const unsigned char* in;
+        unsigned char* out;
+        unsigned long long len;
+        message_slot(bench, t, first + i + l, i + l, &in, &out, &len);
+        if (bench->is_encryption) {
+            ascon_nonce_next(&data->nonces, data->lane_nonce[l]);
+        }
+        lanes[l] = (ascon_lane_t){
+            .k = bench->key,
+            .npub = bench->is_encryption ? data->lane_nonce[l] : bench->nonce,
+            .in = in,
+            .inlen = bench->is_encryption ? len : len + CRYPTO_ABYTES,
+            .out = out
+        };
+        bytes += len;
     }
-    return NULL;
+    if (bench->is_encryption) {
+        ascon_aead_encrypt_x4(lanes, nlanes, bench->variant->x4_rate);
+    } else if (ascon_aead_decrypt_x4(lanes, nlanes, bench->variant->x4_rate)) {
+        data->failures++;
+    }
+    return bytes;
 }
 
-void benchmark_multithreaded(int num_threads, unsigned long long total_size, int is_encryption) {
-    unsigned char* input_data = malloc(CHUNK_SIZE);
-    unsigned char* output_data = malloc(CHUNK_SIZE + 16);
-    if (!input_data || !output_data) {
-        perror("Memory allocation failed");
-        return;
+// One unit of the benchmark engine: up to messages_per_chunk messages
+uint64_t process_chunk(bench_thread_t* t, uint64_t chunk) {
+    const Benchmark* bench = (const Benchmark*)t->config->arg;
+    ThreadData* data = (ThreadData*)t->user;
+    unsigned long long first = chunk * bench->messages_per_chunk;
+    unsigned long long count = bench->total_messages - first;
+    unsigned long long bytes = 0;
+    if (count > bench->messages_per_chunk) {
+        count = bench->messages_per_chunk;
     }
 
-    // Generate random input data, key, and nonce
-    for (unsigned long long i = 0; i < CHUNK_SIZE; i++) {
-        input_data[i] = rand() % 256;
+    if (bench->variant->x4_rate) {
+        for (unsigned long long i = 0; i < count; i += ASCON_X4_LANES) {
+            int nlanes = count - i < ASCON_X4_LANES ? (int)(count - i) : ASCON_X4_LANES;
+            bytes += x4_group(bench, t, first, i, nlanes);
+        }
+        return bytes;
     }
 
-    unsigned char key[KEY_SIZE];
-    unsigned char nonce[NONCE_SIZE];
-    generate_random_key(key);
-    generate_random_nonce(nonce);
-
-#ifdef _WIN32
-    HANDLE* threads = malloc(num_threads * sizeof(HANDLE));
-#else
-    pthread_t* threads = malloc(num_threads * sizeof(pthread_t));
-#endif
+    for (unsigned long long i = 0; i < count; i++) {
+        const unsigned char* in;
+        unsigned char* out;
+        unsigned long long len, out_len;
+        message_slot(bench, t, first + i, i, &in, &out, &len);
+        if (bench->is_encryption) {
+            ascon_nonce_next(&data->nonces, data->lane_nonce[0]);
+            bench->variant->encrypt(out, &out_len, in, len, NULL, 0, NULL, data->lane_nonce[0], bench->key);
+        } else if (bench->variant->decrypt(out, &out_len, NULL, in, len + CRYPTO_ABYTES, NULL, 0, bench->nonce, bench->key)) {
+            data->failures++;
+        }
+        bytes += len;
+    }
+    return bytes;
+}
 
-    ThreadData* thread_data = malloc(num_threads * sizeof(ThreadData));
-    unsigned long long iterations_per_thread = (total_size / CHUNK_SIZE) / num_threads;
+void print_mbps(const char* label, double bytes_per_second) {
+    printf("%s%f MB/s\n", label, bytes_per_second / (1024 * 1024));
+}
 
-    clock_t start = clock();
-    for (int i = 0; i < num_threads; i++) {
-        thread_data[i] = (ThreadData){
-            .input_data = input_data,
-            .output_data = output_data,
-            .key = key,
-            .nonce = nonce,
-            .thread_num = i,
-            .iterations = iterations_per_thread
-        };
+// Runs the whole benchmark once on num_threads threads and prints the results. Returns the
+// throughput in bytes/s (0 on errors); single_thread is that of the 1-thread run, 0 if unknown.
+double benchmark_multithreaded(Benchmark* bench, int num_threads, unsigned long long total_size, double single_thread) {
+    double* thread_throughput = malloc(num_threads * sizeof(double));
+    bench->threads = calloc(num_threads, sizeof(ThreadData));
+    if (!thread_throughput || !bench->threads) {
+        perror("Memory allocation failed");
+        free(thread_throughput);
+        free(bench->threads);
+        return 0;
+    }
 
-#ifdef _WIN32
-        threads[i] = CreateThread(NULL, 0, (LPTHREAD_START_ROUTINE)(is_encryption ? encrypt_chunk : decrypt_chunk), &thread_data[i], 0, NULL);
-#else
-        pthread_create(&threads[i], NULL, is_encryption ? encrypt_chunk : decrypt_chunk, &thread_data[i]);
+    bench_config_t config = {
+        .num_threads = num_threads,
+        .units = (bench->total_messages + bench->messages_per_chunk - 1) / bench->messages_per_chunk,
+        .warmup_units = WARMUP_CHUNKS,
+        .in_size = (bench->messages_per_chunk + 1) * bench->slot_size,
+        .out_size = (bench->messages_per_chunk + 1) * bench->slot_size,
+        .pin = 1,
+        .setup = setup_thread,
+        .start = thread_start,
+        .run = process_chunk,
+#ifdef ASCON_TRACE
+        .teardown = trace_stop,
 #endif
+        .arg = bench
+    };
+    bench_result_t result;
+    uint64_t energy_after;
+    bench->energy_start = 0;
+    if (bench_run(&config, &result, thread_throughput)) {
+        fprintf(stderr, "Could not run the benchmark threads\n");
+        free(thread_throughput);
+        free(bench->threads);
+        return 0;
     }
 
-#ifdef _WIN32
-    WaitForMultipleObjects(num_threads, threads, TRUE, INFINITE);
+    unsigned long long failures = 0;
     for (int i = 0; i < num_threads; i++) {
-        CloseHandle(threads[i]);
+        failures += bench->threads[i].failures;
     }
-#else
+
+    printf("Multithreaded %s %s time for %llu MB: %f seconds\n",
+        bench->variant->name,
+        bench->is_encryption ? "encryption" : "decryption",
+        total_size / (1024 * 1024),
+        result.wall_seconds);
+    print_mbps("Throughput: ", result.throughput);
+    if (bench->message_size != CHUNK_SIZE) {
+        printf("Message rate: %f messages/s (%llu-byte messages)\n",
+            (double)bench->total_messages / result.wall_seconds, bench->message_size);
+    }
+    if (bench->rapl && bench->energy_start > 0 && rapl_read(bench->rapl, &energy_after) == 0) {
+        double uj = rapl_active_uj(bench->rapl, bench->energy_before, energy_after, bench_seconds() - bench->energy_start);
+        printf("Energy: %.3f nJ/byte, %.1f W above idle\n", uj * 1e3 / total_size, uj / 1e6 / result.wall_seconds);
+    }
+    printf("Chunk latency (%llu messages per chunk): p50 %f ms, p99 %f ms\n",
+        bench->messages_per_chunk, result.p50_latency * 1e3, result.p99_latency * 1e3);
+    printf("Per-thread throughput (MB/s):");
     for (int i = 0; i < num_threads; i++) {
-        pthread_join(threads[i], NULL);
+        printf(" %.1f", thread_throughput[i] / (1024 * 1024));
+    }
+    printf("\n");
+    if (single_thread > 0) {
+        printf("Scaling: %.2fx the 1-thread throughput, %.1f%% efficiency\n",
+            result.throughput / single_thread, 100.0 * result.throughput / (single_thread * num_threads));
     }
+#ifdef ASCON_TRACE
+    ascon_trace_counts_t trace = {0};
+    for (int i = 0; i < num_threads; i++) {
+        ascon_trace_merge(&trace, &bench->threads[i].trace);
+    }
+    ascon_trace_report(stdout, &trace);
 #endif
+    if (failures) {
+        printf("Warning: %llu decryptions failed\n", failures);
+    }
 
-    clock_t end = clock();
-    double elapsed_time = (double)(end - start) / CLOCKS_PER_SEC;
-    double throughput = (double)total_size / (1024 * 1024) / elapsed_time;
-
-    printf("Multithreaded %s time for %llu MB: %f seconds\n",
-        is_encryption ? "encryption" : "decryption",
-        total_size / (1024 * 1024),
-        elapsed_time);
-    printf("Throughput: %f MB/s\n", throughput);
-
-    free(input_data);
-    free(output_data);
-    free(thread_data);
-    free(threads);
+    free(thread_throughput);
+    free(bench->threads);
+    bench->threads = NULL;
+    return result.throughput;
 }
 
 int main(int argc, char* argv[]) {
     if (argc < 4) {
-        fprintf(stderr, "Usage: %s <total_size_in_MB> <num_threads> <mode: 0=encryption, 1=decryption>\n", argv[0]);
+        fprintf(stderr, "Usage: %s <total_size_in_MB> <num_threads> <mode: 0=encryption, 1=decryption> [variant: 0=Ascon-128, 1=Ascon-128a, 2=Ascon-80pq, 3=Ascon-128 AVX2x4, 4=Ascon-128a AVX2x4, -1=all] [message_size_in_bytes] [scaling: 1=also run 1, 2, 4, ... threads (default), 0=only num_threads]\n", argv[0]);
         return 1;
     }
 
@@ -319,10 +495,83 @@ int main(int argc, char* argv[]) {
     unsigned long long total_size = total_size_in_mb * 1024 * 1024;
     int num_threads = atoi(argv[2]);
     int mode = atoi(argv[3]);
+    int variant = argc > 4 ? atoi(argv[4]) : 0;
+    if (variant < -1 || variant >= NUM_VARIANTS) {
+        fprintf(stderr, "Unknown variant %d\n", variant);
+        return 1;
+    }
+    unsigned long long message_size = argc > 5 ? strtoull(argv[5], NULL, 10) : CHUNK_SIZE;
+    if (message_size == 0 || message_size > CHUNK_SIZE) {
+        fprintf(stderr, "Message size must be between 1 and %d bytes\n", CHUNK_SIZE);
+        return 1;
+    }
+    int scaling = argc > 6 ? atoi(argv[6]) : 1;
+    if (total_size == 0 || num_threads < 1) {
+        fprintf(stderr, "Size and number of threads must be at least 1\n");
+        return 1;
+    }
+
+    int thread_counts[32];
+    int num_counts = scaling ? bench_thread_counts(num_threads, thread_counts) : 1;
+    if (!scaling) {
+        thread_counts[0] = num_threads;
+    }
+    rapl_t rapl;
+    int have_rapl = rapl_open(&rapl) == 0 && rapl_measure_idle(&rapl, RAPL_IDLE_MS) == 0;
+    if (have_rapl) {
+        printf("Energy: RAPL %s, idle %.0f mW subtracted\n", rapl.zone, rapl.idle_mw);
+    } else {
+        printf("Energy: no RAPL access, no nJ/byte figures\n");
+    }
+    if (num_threads > bench_num_cores()) {
+        printf("Note: %d threads on %d cores, threads will share cores\n", num_threads, bench_num_cores());
+    }
+
+    for (int v = 0; v < NUM_VARIANTS; v++) {
+        if (variant != -1 && variant != v) {
+            continue;
+        }
 
-    printf("Running multithreaded %s with %d threads...\n",
-        mode == 0 ? "encryption" : "decryption", num_threads);
-    benchmark_multithreaded(num_threads, total_size, mode == 0);
+        Benchmark bench = {
+            .variant = &variants[v],
+            .is_encryption = mode == 0,
+            .message_size = message_size,
+            .total_messages = (total_size + message_size - 1) / message_size,
+            .slot_size = message_size + CRYPTO_ABYTES,
+            .rapl = have_rapl ? &rapl : NULL
+        };
+        bench.last_message_size = total_size - (bench.total_messages - 1) * message_size;
+        bench.messages_per_chunk = CHUNK_SIZE / message_size;
+        if (variants[v].x4_rate) {
+            // whole 4-lane groups per chunk
+            bench.messages_per_chunk = (bench.messages_per_chunk + ASCON_X4_LANES - 1) / ASCON_X4_LANES * ASCON_X4_LANES;
+        }
+        testdata_bytes(TESTDATA_KEY, bench.key, KEY_SIZE);
+        testdata_bytes(TESTDATA_NONCE, bench.nonce, NONCE_SIZE);
+        // Threads draw disjoint nonce ranges under one prefix
+        ascon_nonce_init(&bench.nonce_mgr, bench.nonce, NULL);
+
+        double single_thread = 0;
+        double throughput[32];
+        for (int c = 0; c < num_counts; c++) {
+            printf("Running multithreaded %s %s with %d threads...\n",
+                variants[v].name, mode == 0 ? "encryption" : "decryption", thread_counts[c]);
+            throughput[c] = benchmark_multithreaded(&bench, thread_counts[c], total_size, single_thread);
+            if (thread_counts[c] == 1) {
+                single_thread = throughput[c];
+            }
+        }
+
+        if (num_counts > 1) {
+            printf("Scaling summary for %s (threads, MB/s, speedup, efficiency):\n", variants[v].name);
+            for (int c = 0; c < num_counts; c++) {
+                double speedup = single_thread > 0 ? throughput[c] / single_thread : 0;
+                printf("%d, %.1f, %.2f, %.1f%%\n", thread_counts[c], throughput[c] / (1024 * 1024),
+                    speedup, 100.0 * speedup / thread_counts[c]);
+            }
+        }
+        ascon_nonce_destroy(&bench.nonce_mgr);
+    }
 
     return 0;
 }
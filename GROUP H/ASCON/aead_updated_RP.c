@@ -7,8 +7,10 @@
 
 #include "api.h"
 #include "ascon.h"
+#include "nonce.h"
 #include "permutations.h"
 #include "printstate.h"
+#include "testdata.h"
 #include "word.h"
 
 int crypto_aead_encrypt(unsigned char* c, unsigned long long* clen,
@@ -188,35 +190,28 @@ int crypto_aead_decrypt(unsigned char* m, unsigned long long* mlen,
 
 
 #define KEY_SIZE 16   // ASCON key size
-#define NONCE_SIZE 12 // ASCON nonce size
+#define NONCE_SIZE CRYPTO_NPUBBYTES // crypto_aead_* read 16 bytes of nonce
 #define CHUNK_SIZE (1 * 1024 * 1024) // 1 MB
 
 typedef struct {
     unsigned char* input_data;
     unsigned char* output_data;
     unsigned char* key;
-    unsigned char* nonce;
+    unsigned char* nonce;        // nonce of the decryption input
+    ascon_nonce_mgr_t* nonce_mgr; // fresh nonce for every encryption
     unsigned long long iterations;
 } ThreadData;
 
-void generate_random_key(unsigned char* key) {
-    for (size_t i = 0; i < KEY_SIZE; i++) {
-        key[i] = rand() % 256;
-    }
-}
-
-void generate_random_nonce(unsigned char* nonce) {
-    for (size_t i = 0; i < NONCE_SIZE; i++) {
-        nonce[i] = rand() % 256;
-    }
-}
-
 void* encrypt_chunk(void* args) {
     ThreadData* data = (ThreadData*)args;
     unsigned long long ciphertext_len = 0;
+    unsigned char nonce[NONCE_SIZE];
+    ascon_nonce_ctx_t nonces;
 
+    ascon_nonce_thread_init(&nonces, data->nonce_mgr);
     for (unsigned long long i = 0; i < data->iterations; i++) {
-        crypto_aead_encrypt(data->output_data, &ciphertext_len, data->input_data, CHUNK_SIZE, NULL, 0, NULL, data->nonce, data->key);
+        ascon_nonce_next(&nonces, nonce);
+        crypto_aead_encrypt(data->output_data, &ciphertext_len, data->input_data, CHUNK_SIZE, NULL, 0, NULL, nonce, data->key);
     }
 
     return NULL;
@@ -241,15 +236,16 @@ void benchmark_multithreaded(int num_threads, unsigned long long total_size, int
         return;
     }
 
-    // Generate random input data, key, and nonce
-    for (unsigned long long i = 0; i < CHUNK_SIZE; i++) {
-        input_data[i] = rand() % 256;
-    }
+    // Reproducible input data, key, and nonce (testdata.c)
+    testdata_bytes(TESTDATA_MESSAGE, input_data, CHUNK_SIZE);
 
     unsigned char key[KEY_SIZE];
     unsigned char nonce[NONCE_SIZE];
-    generate_random_key(key);
-    generate_random_nonce(nonce);
+    testdata_bytes(TESTDATA_KEY, key, KEY_SIZE);
+    testdata_bytes(TESTDATA_NONCE, nonce, NONCE_SIZE);
+    // Threads draw disjoint nonce ranges under one prefix
+    ascon_nonce_mgr_t nonce_mgr;
+    ascon_nonce_init(&nonce_mgr, nonce, NULL);
 
     pthread_t* threads = malloc(num_threads * sizeof(pthread_t));
     ThreadData* thread_data = malloc(num_threads * sizeof(ThreadData));
@@ -265,6 +261,7 @@ void benchmark_multithreaded(int num_threads, unsigned long long total_size, int
             .output_data = output_data,
             .key = key,
             .nonce = nonce,
+            .nonce_mgr = &nonce_mgr,
             .iterations = iterations_per_thread
         };
 
@@ -287,6 +284,7 @@ void benchmark_multithreaded(int num_threads, unsigned long long total_size, int
         elapsed_time);
     printf("Throughput: %f MB/s\n", throughput);
 
+    ascon_nonce_destroy(&nonce_mgr);
     free(input_data);
     free(output_data);
     free(thread_data);
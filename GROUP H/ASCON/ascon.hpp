@@ -0,0 +1,347 @@
+#ifndef ASCON_HPP_
+#define ASCON_HPP_
+
+#include <stddef.h>
+#include <stdint.h>
+
+extern "C" {
+#include "ascon.h"
+#include "constants.h"
+#include "hash.h"
+#include "round.h"
+#include "trace.h"
+#include "word.h"
+}
+
+/* -------------------------------------------------------------------------
+ * Header-only, compile-time specialized Ascon (C++11).
+ *
+ * The variants differ only in the values of constants.h: rate, pa/pb round
+ * counts, key size and IV. Here those are constexpr traits, and
+ *
+ *   ascon<ascon128>, ascon<ascon128a>, ascon<ascon80pq>   AEAD
+ *   ascon<asconhash>, ascon<asconhasha>                   hash
+ *   ascon<asconxof>, ascon<asconxofa>                     XOF
+ *
+ * all run through one sponge core (duplex() below), instantiated per rate,
+ * pb and mode (absorb, encrypt, decrypt). Permutations are unrolled from
+ * the round count with the ROUND() of round.h, so every variant compiles to
+ * its own kernel without branches on rate or rounds, and the trace hooks of
+ * trace.h work here too. Results are identical to ascon_aead.c/hash.c.
+ * ---------------------------------------------------------------------- */
+
+struct ascon128 {
+  static constexpr unsigned key_bytes = ASCON_128_KEYBYTES;
+  static constexpr unsigned rate = ASCON_128_RATE;
+  static constexpr unsigned pa = ASCON_128_PA_ROUNDS;
+  static constexpr unsigned pb = ASCON_128_PB_ROUNDS;
+  static constexpr uint64_t iv = ASCON_128_IV;
+};
+
+struct ascon128a {
+  static constexpr unsigned key_bytes = ASCON_128A_KEYBYTES;
+  static constexpr unsigned rate = ASCON_128A_RATE;
+  static constexpr unsigned pa = ASCON_128A_PA_ROUNDS;
+  static constexpr unsigned pb = ASCON_128A_PB_ROUNDS;
+  static constexpr uint64_t iv = ASCON_128A_IV;
+};
+
+struct ascon80pq {
+  static constexpr unsigned key_bytes = ASCON_80PQ_KEYBYTES;
+  static constexpr unsigned rate = ASCON_128_RATE;
+  static constexpr unsigned pa = ASCON_128_PA_ROUNDS;
+  static constexpr unsigned pb = ASCON_128_PB_ROUNDS;
+  static constexpr uint64_t iv = ASCON_80PQ_IV;
+};
+
+/* key_bytes == 0: unkeyed; out_bytes == 0: extendable output */
+struct asconhash {
+  static constexpr unsigned key_bytes = 0;
+  static constexpr unsigned out_bytes = ASCON_HASH_BYTES;
+  static constexpr unsigned rate = ASCON_HASH_RATE;
+  static constexpr unsigned pa = ASCON_HASH_PA_ROUNDS;
+  static constexpr unsigned pb = ASCON_HASH_PB_ROUNDS;
+  static constexpr uint64_t iv = ASCON_HASH_IV;
+};
+
+struct asconhasha {
+  static constexpr unsigned key_bytes = 0;
+  static constexpr unsigned out_bytes = ASCON_HASH_BYTES;
+  static constexpr unsigned rate = ASCON_HASH_RATE;
+  static constexpr unsigned pa = ASCON_HASHA_PA_ROUNDS;
+  static constexpr unsigned pb = ASCON_HASHA_PB_ROUNDS;
+  static constexpr uint64_t iv = ASCON_HASHA_IV;
+};
+
+struct asconxof {
+  static constexpr unsigned key_bytes = 0;
+  static constexpr unsigned out_bytes = 0;
+  static constexpr unsigned rate = ASCON_HASH_RATE;
+  static constexpr unsigned pa = ASCON_HASH_PA_ROUNDS;
+  static constexpr unsigned pb = ASCON_HASH_PB_ROUNDS;
+  static constexpr uint64_t iv = ASCON_XOF_IV;
+};
+
+struct asconxofa {
+  static constexpr unsigned key_bytes = 0;
+  static constexpr unsigned out_bytes = 0;
+  static constexpr unsigned rate = ASCON_HASH_RATE;
+  static constexpr unsigned pa = ASCON_HASHA_PA_ROUNDS;
+  static constexpr unsigned pb = ASCON_HASHA_PB_ROUNDS;
+  static constexpr uint64_t iv = ASCON_XOFA_IV;
+};
+
+namespace ascon_detail {
+
+/* round i of 12 adds the constant (0xf - i) << 4 | i */
+template <unsigned I, unsigned N>
+struct rounds {
+  static inline void run(ascon_state_t* s) {
+    ROUND(s, (uint8_t)((0xf - I) << 4 | I));
+    rounds<I + 1, N>::run(s);
+  }
+};
+
+template <unsigned N>
+struct rounds<N, N> {
+  static inline void run(ascon_state_t*) {}
+};
+
+/* the last R rounds, i.e. P12, P8 or P6 */
+template <unsigned R>
+inline void permute(ascon_state_t* s) {
+  static_assert(R >= 1 && R <= 12, "Ascon has 1 to 12 rounds");
+  ASCON_TRACE_PERM_BEGIN(R);
+  rounds<12 - R, 12>::run(s);
+  ASCON_TRACE_PERM_END(R);
+}
+
+/* What the sponge does with one rate word x and the n bytes at offset pos
+ * of the input (and output). Absorbing has no output, out may be null. */
+struct absorb_mode {
+  static inline void word(uint64_t* x, uint8_t*, const uint8_t* in,
+                          size_t pos, int n) {
+    *x ^= LOADBYTES(in + pos, n);
+  }
+};
+
+struct encrypt_mode {
+  static inline void word(uint64_t* x, uint8_t* out, const uint8_t* in,
+                          size_t pos, int n) {
+    *x ^= LOADBYTES(in + pos, n);
+    STOREBYTES(out + pos, *x, n);
+  }
+};
+
+struct decrypt_mode {
+  static inline void word(uint64_t* x, uint8_t* out, const uint8_t* in,
+                          size_t pos, int n) {
+    uint64_t c = LOADBYTES(in + pos, n);
+    STOREBYTES(out + pos, *x ^ c, n);
+    *x = CLEARBYTES(*x, n) | c;
+  }
+};
+
+/* all words of one full block; resolved at compile time */
+template <class Mode, unsigned I, unsigned N>
+struct block_words {
+  static inline void run(ascon_state_t* s, uint8_t* out, const uint8_t* in,
+                         size_t pos) {
+    Mode::word(&s->x[I], out, in, pos + 8 * I, 8);
+    block_words<Mode, I + 1, N>::run(s, out, in, pos);
+  }
+};
+
+template <class Mode, unsigned N>
+struct block_words<Mode, N, N> {
+  static inline void run(ascon_state_t*, uint8_t*, const uint8_t*, size_t) {}
+};
+
+/* The sponge core shared by associated data, message and hash input:
+ * every full block followed by pB, then the padded last (partial, possibly
+ * empty) block. The caller applies the permutation that follows it. */
+template <unsigned Rate, unsigned PB, class Mode>
+inline void duplex(ascon_state_t* s, uint8_t* out, const uint8_t* in,
+                   size_t len) {
+  static_assert(Rate % 8 == 0 && Rate <= 40, "rate must be whole words");
+  size_t pos = 0;
+  for (; len - pos >= Rate; pos += Rate) {
+    block_words<Mode, 0, Rate / 8>::run(s, out, in, pos);
+    permute<PB>(s);
+  }
+  unsigned i = 0;
+  for (; len - pos >= 8; ++i, pos += 8) Mode::word(&s->x[i], out, in, pos, 8);
+  Mode::word(&s->x[i], out, in, pos, (int)(len - pos));
+  s->x[i] ^= PAD(len - pos);
+}
+
+/* 192-bit key block K0 || K1 || K2 with the key right-aligned, i.e. K0 is
+ * 0 for a 128-bit key and the first 32 key bits for Ascon-80pq */
+template <unsigned KeyBytes>
+struct key_words {
+  static_assert(KeyBytes > 8 && KeyBytes <= 24, "key of 9 to 24 bytes");
+  uint64_t k[3];
+  explicit key_words(const uint8_t* key) {
+    const unsigned first = KeyBytes - 16;
+    k[0] = first ? LOADBYTES(key, first) >> (64 - 8 * first) % 64 : 0;
+    k[1] = LOADBYTES(key + first, 8);
+    k[2] = LOADBYTES(key + first + 8, 8);
+  }
+  /* the key moved to the top of the 192 bits */
+  uint64_t top(unsigned i) const {
+    const unsigned sh = 192 - 8 * KeyBytes;
+    if (sh == 64) return i < 2 ? k[i + 1] : 0;
+    return (k[i] << (sh % 64)) | (i < 2 ? k[i + 1] >> ((64 - sh) % 64) : 0);
+  }
+};
+
+} /* namespace ascon_detail */
+
+template <class Variant>
+class ascon {
+ public:
+  typedef Variant traits;
+  static constexpr unsigned rate = Variant::rate;
+  static constexpr unsigned key_bytes = Variant::key_bytes;
+  static constexpr unsigned nonce_bytes = 16;
+  static constexpr unsigned tag_bytes = 16;
+
+  /* c gets mlen bytes, tag gets tag_bytes; c may be m */
+  static void encrypt(uint8_t* c, uint8_t* tag, const uint8_t* m,
+                      size_t mlen, const uint8_t* ad, size_t adlen,
+                      const uint8_t* npub, const uint8_t* k) {
+    static_assert(Variant::key_bytes != 0, "encrypt needs an AEAD variant");
+    ascon_state_t s;
+    const ascon_detail::key_words<key_bytes> key(k);
+    initialize(&s, key, npub);
+    associated_data(&s, ad, adlen);
+    ASCON_TRACE_ENTER(ASCON_PHASE_MSG, mlen);
+    ascon_detail::duplex<rate, Variant::pb, ascon_detail::encrypt_mode>(
+        &s, c, m, mlen);
+    ASCON_TRACE_LEAVE();
+    finalize(&s, key);
+    STOREBYTES(tag, s.x[3], 8);
+    STOREBYTES(tag + 8, s.x[4], 8);
+  }
+
+  /* 0 if the tag is valid, -1 otherwise; m may be c. The plaintext is not
+   * authentic (and should be discarded) unless 0 is returned. */
+  static int decrypt(uint8_t* m, const uint8_t* c, size_t clen,
+                     const uint8_t* tag, const uint8_t* ad, size_t adlen,
+                     const uint8_t* npub, const uint8_t* k) {
+    static_assert(Variant::key_bytes != 0, "decrypt needs an AEAD variant");
+    ascon_state_t s;
+    const ascon_detail::key_words<key_bytes> key(k);
+    initialize(&s, key, npub);
+    associated_data(&s, ad, adlen);
+    ASCON_TRACE_ENTER(ASCON_PHASE_MSG, clen);
+    ascon_detail::duplex<rate, Variant::pb, ascon_detail::decrypt_mode>(
+        &s, m, c, clen);
+    ASCON_TRACE_LEAVE();
+    finalize(&s, key);
+    /* constant time */
+    uint64_t d = (s.x[3] ^ LOADBYTES(tag, 8)) | (s.x[4] ^ LOADBYTES(tag + 8, 8));
+    return -(int)((d | (0 - d)) >> 63);
+  }
+
+  /* crypto_aead_encrypt/crypto_aead_decrypt interface (c = ciphertext ||
+   * tag), for drop-in use in the benchmarks */
+  static int aead_encrypt(unsigned char* c, unsigned long long* clen,
+                          const unsigned char* m, unsigned long long mlen,
+                          const unsigned char* ad, unsigned long long adlen,
+                          const unsigned char* nsec,
+                          const unsigned char* npub, const unsigned char* k) {
+    (void)nsec;
+    *clen = mlen + tag_bytes;
+    encrypt(c, c + mlen, m, (size_t)mlen, ad, (size_t)adlen, npub, k);
+    return 0;
+  }
+
+  static int aead_decrypt(unsigned char* m, unsigned long long* mlen,
+                          unsigned char* nsec, const unsigned char* c,
+                          unsigned long long clen, const unsigned char* ad,
+                          unsigned long long adlen, const unsigned char* npub,
+                          const unsigned char* k) {
+    (void)nsec;
+    if (clen < tag_bytes) return -1;
+    *mlen = clen - tag_bytes;
+    return decrypt(m, c, (size_t)*mlen, c + *mlen, ad, (size_t)adlen, npub,
+                   k);
+  }
+
+  /* Ascon-Hash/Hasha: out gets Variant::out_bytes bytes */
+  static void hash(uint8_t* out, const uint8_t* in, size_t len) {
+    static_assert(Variant::key_bytes == 0 && Variant::out_bytes != 0,
+                  "hash needs asconhash or asconhasha");
+    xof_squeeze(out, Variant::out_bytes, in, len);
+  }
+
+  /* Ascon-XOF/XOFa: any output length */
+  static void xof(uint8_t* out, size_t outlen, const uint8_t* in,
+                  size_t len) {
+    static_assert(Variant::key_bytes == 0 && Variant::out_bytes == 0,
+                  "xof needs asconxof or asconxofa");
+    xof_squeeze(out, outlen, in, len);
+  }
+
+ private:
+  static inline void initialize(ascon_state_t* s,
+                                const ascon_detail::key_words<key_bytes>& key,
+                                const uint8_t* npub) {
+    ASCON_TRACE_ENTER(ASCON_PHASE_INIT, 0);
+    s->x[0] = Variant::iv | key.k[0];
+    s->x[1] = key.k[1];
+    s->x[2] = key.k[2];
+    s->x[3] = LOADBYTES(npub, 8);
+    s->x[4] = LOADBYTES(npub + 8, 8);
+    ascon_detail::permute<Variant::pa>(s);
+    s->x[2] ^= key.k[0];
+    s->x[3] ^= key.k[1];
+    s->x[4] ^= key.k[2];
+    ASCON_TRACE_LEAVE();
+  }
+
+  static inline void associated_data(ascon_state_t* s, const uint8_t* ad,
+                                     size_t adlen) {
+    ASCON_TRACE_ENTER(ASCON_PHASE_AD, adlen);
+    if (adlen) {
+      ascon_detail::duplex<rate, Variant::pb, ascon_detail::absorb_mode>(
+          s, nullptr, ad, adlen);
+      ascon_detail::permute<Variant::pb>(s);
+    }
+    s->x[4] ^= DSEP();
+    ASCON_TRACE_LEAVE();
+  }
+
+  /* key after the rate, permutation, key into the tag */
+  static inline void finalize(ascon_state_t* s,
+                              const ascon_detail::key_words<key_bytes>& key) {
+    ASCON_TRACE_ENTER(ASCON_PHASE_FINAL, 0);
+    s->x[rate / 8] ^= key.top(0);
+    s->x[rate / 8 + 1] ^= key.top(1);
+    if (rate / 8 + 2 < 5) s->x[(rate / 8 + 2) % 5] ^= key.top(2);
+    ascon_detail::permute<Variant::pa>(s);
+    s->x[3] ^= key.k[1];
+    s->x[4] ^= key.k[2];
+    ASCON_TRACE_LEAVE();
+  }
+
+  static inline void xof_squeeze(uint8_t* out, size_t outlen,
+                                 const uint8_t* in, size_t len) {
+    static_assert(Variant::rate == 8, "hash output is squeezed from x0");
+    ascon_state_t s = {{Variant::iv, 0, 0, 0, 0}};
+    ascon_detail::permute<Variant::pa>(&s);
+    ascon_detail::duplex<rate, Variant::pb, ascon_detail::absorb_mode>(
+        &s, nullptr, in, len);
+    ascon_detail::permute<Variant::pa>(&s);
+    while (outlen > rate) {
+      STOREBYTES(out, s.x[0], 8);
+      ascon_detail::permute<Variant::pb>(&s);
+      out += rate;
+      outlen -= rate;
+    }
+    STOREBYTES(out, s.x[0], (int)outlen);
+  }
+};
+
+#endif /* ASCON_HPP_ */
@@ -0,0 +1,88 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "aead_stream.h"
+#include "ascon32.h"
+
+#define MAX_MSG 80 // several blocks of both rates plus every partial length
+#define MAX_AD 40
+
+typedef int (*Encrypt32)(unsigned char*, unsigned long long*, const unsigned char*, unsigned long long,
+                         const unsigned char*, unsigned long long, const unsigned char*,
+                         const unsigned char*, const unsigned char*);
+typedef int (*Decrypt32)(unsigned char*, unsigned long long*, unsigned char*, const unsigned char*,
+                         unsigned long long, const unsigned char*, unsigned long long,
+                         const unsigned char*, const unsigned char*);
+
+// Reference result from the 64-bit code: ciphertext followed by the tag
+void encrypt64(int variant, const uint8_t* key, const uint8_t* nonce, const uint8_t* ad, size_t adlen,
+               const uint8_t* msg, size_t mlen, uint8_t* out) {
+    ascon_aead_ctx_t ctx;
+    ascon_aead_init(&ctx, variant, key, nonce);
+    ascon_aead_update_ad(&ctx, ad, adlen);
+    ascon_aead_encrypt_update(&ctx, out, msg, mlen);
+    ascon_aead_encrypt_final(&ctx, out + mlen);
+}
+
+// Compares ascon32.c with the 64-bit code for every message and AD length up to
+// MAX_MSG/MAX_AD, and checks decryption, in-place use and tag rejection
+int check_variant(const char* name, int variant, Encrypt32 encrypt, Decrypt32 decrypt, uint32_t* checksum) {
+    uint8_t key[ASCON32_KEYBYTES], nonce[ASCON32_NPUBBYTES], ad[MAX_AD], msg[MAX_MSG];
+    uint8_t expected[MAX_MSG + ASCON32_ABYTES], actual[MAX_MSG + ASCON32_ABYTES], plain[MAX_MSG];
+    unsigned long long len;
+    int failures = 0;
+
+    for (int i = 0; i < ASCON32_KEYBYTES; i++) key[i] = (uint8_t)i;
+    for (int i = 0; i < ASCON32_NPUBBYTES; i++) nonce[i] = (uint8_t)(0x80 + i);
+    for (int i = 0; i < MAX_AD; i++) ad[i] = (uint8_t)(0x40 + 3 * i);
+    for (int i = 0; i < MAX_MSG; i++) msg[i] = (uint8_t)(7 * i + 1);
+
+    for (int adlen = 0; adlen <= MAX_AD; adlen++) {
+        for (int mlen = 0; mlen <= MAX_MSG; mlen++) {
+            encrypt64(variant, key, nonce, ad, adlen, msg, mlen, expected);
+            encrypt(actual, &len, msg, mlen, ad, adlen, NULL, nonce, key);
+            if (len != (unsigned long long)mlen + ASCON32_ABYTES || memcmp(actual, expected, len) != 0) {
+                printf("%s: encryption differs (adlen %d, mlen %d)\n", name, adlen, mlen);
+                failures++;
+                continue;
+            }
+            for (unsigned long long i = 0; i < len; i++) {
+                *checksum = (*checksum ^ actual[i]) * 16777619u; // FNV-1a
+            }
+            if (decrypt(plain, &len, NULL, actual, mlen + ASCON32_ABYTES, ad, adlen, nonce, key) != 0 ||
+                len != (unsigned long long)mlen || memcmp(plain, msg, mlen) != 0) {
+                printf("%s: decryption failed (adlen %d, mlen %d)\n", name, adlen, mlen);
+                failures++;
+            }
+            // c == m
+            if (decrypt(actual, &len, NULL, actual, mlen + ASCON32_ABYTES, ad, adlen, nonce, key) != 0 ||
+                memcmp(actual, msg, mlen) != 0) {
+                printf("%s: in-place decryption failed (adlen %d, mlen %d)\n", name, adlen, mlen);
+                failures++;
+            }
+            memcpy(actual, expected, mlen + ASCON32_ABYTES);
+            actual[(adlen + mlen) % (mlen + ASCON32_ABYTES)] ^= 0x01;
+            if (decrypt(plain, &len, NULL, actual, mlen + ASCON32_ABYTES, ad, adlen, nonce, key) == 0) {
+                printf("%s: modified ciphertext accepted (adlen %d, mlen %d)\n", name, adlen, mlen);
+                failures++;
+            }
+        }
+    }
+    printf("%s: %d of %d cases differ from the 64-bit implementation\n", name, failures,
+           (MAX_AD + 1) * (MAX_MSG + 1));
+    return failures;
+}
+
+int main(void) {
+    uint32_t checksum = 2166136261u;
+    int failures = 0;
+
+    printf("Checking ascon32.c (%d-bit build)\n", (int)(8 * sizeof(void*)));
+    failures += check_variant("Ascon-128", ASCON_AEAD_128, ascon32_128_encrypt, ascon32_128_decrypt, &checksum);
+    failures += check_variant("Ascon-128a", ASCON_AEAD_128A, ascon32_128a_encrypt, ascon32_128a_decrypt, &checksum);
+    printf("Checksum of all ciphertexts and tags: %08lx\n", (unsigned long)checksum);
+    printf(failures ? "FAILED\n" : "OK\n");
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,165 @@
+#include "ascon_aead.h"
+
+int ascon128_aead_encrypt(unsigned char* c, unsigned long long* clen,
+                          const unsigned char* m, unsigned long long mlen,
+                          const unsigned char* ad, unsigned long long adlen,
+                          const unsigned char* nsec, const unsigned char* npub,
+                          const unsigned char* k) {
+  (void)nsec;
+
+  /* set ciphertext size */
+  *clen = mlen + CRYPTO_ABYTES;
+
+  /* load key */
+  const uint64_t K0 = LOADBYTES(k, 8);
+  const uint64_t K1 = LOADBYTES(k + 8, 8);
+
+  ascon_state_t s;
+  ascon_initaead(&s, ASCON_128_IV, K0, K1, npub);
+  ascon_adata(&s, ad, adlen, ASCON_128_RATE);
+  ascon_encrypt(&s, c, m, mlen, ASCON_128_RATE);
+  ascon_final(&s, K0, K1, ASCON_128_RATE);
+
+  /* get tag */
+  c += mlen;
+  STOREBYTES(c, s.x[3], 8);
+  STOREBYTES(c + 8, s.x[4], 8);
+
+  return 0;
+}
+
+int ascon128_aead_decrypt(unsigned char* m, unsigned long long* mlen,
+                          unsigned char* nsec, const unsigned char* c,
+                          unsigned long long clen, const unsigned char* ad,
+                          unsigned long long adlen, const unsigned char* npub,
+                          const unsigned char* k) {
+  (void)nsec;
+
+  if (clen < CRYPTO_ABYTES) return -1;
+
+  /* set plaintext size */
+  *mlen = clen - CRYPTO_ABYTES;
+
+  /* load key */
+  const uint64_t K0 = LOADBYTES(k, 8);
+  const uint64_t K1 = LOADBYTES(k + 8, 8);
+
+  ascon_state_t s;
+  ascon_initaead(&s, ASCON_128_IV, K0, K1, npub);
+  ascon_adata(&s, ad, adlen, ASCON_128_RATE);
+  ascon_decrypt(&s, m, c, *mlen, ASCON_128_RATE);
+  ascon_final(&s, K0, K1, ASCON_128_RATE);
+
+  /* verify tag */
+  return ascon_verify(c + *mlen, &s);
+}
+
+int ascon128a_aead_encrypt(unsigned char* c, unsigned long long* clen,
+                           const unsigned char* m, unsigned long long mlen,
+                           const unsigned char* ad, unsigned long long adlen,
+                           const unsigned char* nsec,
+                           const unsigned char* npub, const unsigned char* k) {
+  (void)nsec;
+
+  /* set ciphertext size */
+  *clen = mlen + CRYPTO_ABYTES;
+
+  /* load key */
+  const uint64_t K0 = LOADBYTES(k, 8);
+  const uint64_t K1 = LOADBYTES(k + 8, 8);
+
+  ascon_state_t s;
+  ascon_initaead(&s, ASCON_128A_IV, K0, K1, npub);
+  ascon_adata(&s, ad, adlen, ASCON_128A_RATE);
+  ascon_encrypt(&s, c, m, mlen, ASCON_128A_RATE);
+  ascon_final(&s, K0, K1, ASCON_128A_RATE);
+
+  /* get tag */
+  c += mlen;
+  STOREBYTES(c, s.x[3], 8);
+  STOREBYTES(c + 8, s.x[4], 8);
+
+  return 0;
+}
+
+int ascon128a_aead_decrypt(unsigned char* m, unsigned long long* mlen,
+                           unsigned char* nsec, const unsigned char* c,
+                           unsigned long long clen, const unsigned char* ad,
+                           unsigned long long adlen, const unsigned char* npub,
+                           const unsigned char* k) {
+  (void)nsec;
+
+  if (clen < CRYPTO_ABYTES) return -1;
+
+  /* set plaintext size */
+  *mlen = clen - CRYPTO_ABYTES;
+
+  /* load key */
+  const uint64_t K0 = LOADBYTES(k, 8);
+  const uint64_t K1 = LOADBYTES(k + 8, 8);
+
+  ascon_state_t s;
+  ascon_initaead(&s, ASCON_128A_IV, K0, K1, npub);
+  ascon_adata(&s, ad, adlen, ASCON_128A_RATE);
+  ascon_decrypt(&s, m, c, *mlen, ASCON_128A_RATE);
+  ascon_final(&s, K0, K1, ASCON_128A_RATE);
+
+  /* verify tag */
+  return ascon_verify(c + *mlen, &s);
+}
+
+int ascon80pq_aead_encrypt(unsigned char* c, unsigned long long* clen,
+                           const unsigned char* m, unsigned long long mlen,
+                           const unsigned char* ad, unsigned long long adlen,
+                           const unsigned char* nsec,
+                           const unsigned char* npub, const unsigned char* k) {
+  (void)nsec;
+
+  /* set ciphertext size */
+  *clen = mlen + CRYPTO_ABYTES;
+
+  /* load key */
+  const uint64_t K0 = LOADBYTES(k, 4) >> 32;
+  const uint64_t K1 = LOADBYTES(k + 4, 8);
+  const uint64_t K2 = LOADBYTES(k + 12, 8);
+
+  ascon_state_t s;
+  ascon80pq_initaead(&s, K0, K1, K2, npub);
+  ascon_adata(&s, ad, adlen, ASCON_128_RATE);
+  ascon_encrypt(&s, c, m, mlen, ASCON_128_RATE);
+  ascon80pq_final(&s, K0, K1, K2);
+
+  /* get tag */
+  c += mlen;
+  STOREBYTES(c, s.x[3], 8);
+  STOREBYTES(c + 8, s.x[4], 8);
+
+  return 0;
+}
+
+int ascon80pq_aead_decrypt(unsigned char* m, unsigned long long* mlen,
+                           unsigned char* nsec, const unsigned char* c,
+                           unsigned long long clen, const unsigned char* ad,
+                           unsigned long long adlen, const unsigned char* npub,
+                           const unsigned char* k) {
+  (void)nsec;
+
+  if (clen < CRYPTO_ABYTES) return -1;
+
+  /* set plaintext size */
+  *mlen = clen - CRYPTO_ABYTES;
+
+  /* load key */
+  const uint64_t K0 = LOADBYTES(k, 4) >> 32;
+  const uint64_t K1 = LOADBYTES(k + 4, 8);
+  const uint64_t K2 = LOADBYTES(k + 12, 8);
+
+  ascon_state_t s;
+  ascon80pq_initaead(&s, K0, K1, K2, npub);
+  ascon_adata(&s, ad, adlen, ASCON_128_RATE);
+  ascon_decrypt(&s, m, c, *mlen, ASCON_128_RATE);
+  ascon80pq_final(&s, K0, K1, K2);
+
+  /* verify tag */
+  return ascon_verify(c + *mlen, &s);
+}
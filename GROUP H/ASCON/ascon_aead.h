@@ -0,0 +1,257 @@
+#ifndef ASCON_AEAD_H_
+#define ASCON_AEAD_H_
+
+#include <stdint.h>
+
+#include "api.h"
+#include "ascon.h"
+#include "constants.h"
+#include "permutations.h"
+#include "printstate.h"
+#include "trace.h"
+#include "word.h"
+
+/* Phases of the Ascon AEAD modes. Ascon-128 and Ascon-128a differ only in
+ * the rate (8 or 16 bytes) and in pB (P6 or P8), which are passed as
+ * arguments; every caller passes constants, so each entry point is
+ * specialized by the compiler. */
+
+static inline void ascon_pb(ascon_state_t* s, int rate) {
+  if (rate == ASCON_128A_RATE)
+    P8(s);
+  else
+    P6(s);
+}
+
+static inline void ascon_initaead(ascon_state_t* s, uint64_t iv, uint64_t K0,
+                                  uint64_t K1, const uint8_t* npub) {
+  ASCON_TRACE_ENTER(ASCON_PHASE_INIT, 0);
+  s->x[0] = iv;
+  s->x[1] = K0;
+  s->x[2] = K1;
+  s->x[3] = LOADBYTES(npub, 8);
+  s->x[4] = LOADBYTES(npub + 8, 8);
+  printstate("init 1st key xor", s);
+  P12(s);
+  s->x[3] ^= K0;
+  s->x[4] ^= K1;
+  printstate("init 2nd key xor", s);
+  ASCON_TRACE_LEAVE();
+}
+
+static inline void ascon_adata(ascon_state_t* s, const uint8_t* ad,
+                               uint64_t adlen, int rate) {
+  ASCON_TRACE_ENTER(ASCON_PHASE_AD, adlen);
+  if (adlen) {
+    /* full associated data blocks */
+    while (adlen >= (uint64_t)rate) {
+      s->x[0] ^= LOADBYTES(ad, 8);
+      if (rate == 16) s->x[1] ^= LOADBYTES(ad + 8, 8);
+      printstate("absorb adata", s);
+      ascon_pb(s, rate);
+      ad += rate;
+      adlen -= rate;
+    }
+    /* final associated data block */
+    uint64_t* px = &s->x[0];
+    if (rate == 16 && adlen >= 8) {
+      s->x[0] ^= LOADBYTES(ad, 8);
+      px = &s->x[1];
+      ad += 8;
+      adlen -= 8;
+    }
+    *px ^= LOADBYTES(ad, (int)adlen);
+    *px ^= PAD(adlen);
+    printstate("pad adata", s);
+    ascon_pb(s, rate);
+  }
+  /* domain separation */
+  s->x[4] ^= DSEP();
+  printstate("domain separation", s);
+  ASCON_TRACE_LEAVE();
+}
+
+static inline void ascon_encrypt(ascon_state_t* s, uint8_t* c,
+                                 const uint8_t* m, uint64_t mlen, int rate) {
+  ASCON_TRACE_ENTER(ASCON_PHASE_MSG, mlen);
+  /* full plaintext blocks */
+  while (mlen >= (uint64_t)rate) {
+    s->x[0] ^= LOADBYTES(m, 8);
+    STOREBYTES(c, s->x[0], 8);
+    if (rate == 16) {
+      s->x[1] ^= LOADBYTES(m + 8, 8);
+      STOREBYTES(c + 8, s->x[1], 8);
+    }
+    printstate("absorb plaintext", s);
+    ascon_pb(s, rate);
+    m += rate;
+    c += rate;
+    mlen -= rate;
+  }
+  /* final plaintext block */
+  uint64_t* px = &s->x[0];
+  if (rate == 16 && mlen >= 8) {
+    s->x[0] ^= LOADBYTES(m, 8);
+    STOREBYTES(c, s->x[0], 8);
+    px = &s->x[1];
+    m += 8;
+    c += 8;
+    mlen -= 8;
+  }
+  *px ^= LOADBYTES(m, (int)mlen);
+  STOREBYTES(c, *px, (int)mlen);
+  *px ^= PAD(mlen);
+  printstate("pad plaintext", s);
+  ASCON_TRACE_LEAVE();
+}
+
+static inline void ascon_decrypt(ascon_state_t* s, uint8_t* m,
+                                 const uint8_t* c, uint64_t clen, int rate) {
+  ASCON_TRACE_ENTER(ASCON_PHASE_MSG, clen);
+  /* full ciphertext blocks */
+  while (clen >= (uint64_t)rate) {
+    uint64_t c0 = LOADBYTES(c, 8);
+    STOREBYTES(m, s->x[0] ^ c0, 8);
+    s->x[0] = c0;
+    if (rate == 16) {
+      uint64_t c1 = LOADBYTES(c + 8, 8);
+      STOREBYTES(m + 8, s->x[1] ^ c1, 8);
+      s->x[1] = c1;
+    }
+    printstate("insert ciphertext", s);
+    ascon_pb(s, rate);
+    m += rate;
+    c += rate;
+    clen -= rate;
+  }
+  /* final ciphertext block */
+  uint64_t* px = &s->x[0];
+  if (rate == 16 && clen >= 8) {
+    uint64_t c0 = LOADBYTES(c, 8);
+    STOREBYTES(m, s->x[0] ^ c0, 8);
+    s->x[0] = c0;
+    px = &s->x[1];
+    m += 8;
+    c += 8;
+    clen -= 8;
+  }
+  uint64_t c0 = LOADBYTES(c, (int)clen);
+  STOREBYTES(m, *px ^ c0, (int)clen);
+  *px = CLEARBYTES(*px, (int)clen);
+  *px |= c0;
+  *px ^= PAD(clen);
+  printstate("pad ciphertext", s);
+  ASCON_TRACE_LEAVE();
+}
+
+static inline void ascon_final(ascon_state_t* s, uint64_t K0, uint64_t K1,
+                               int rate) {
+  ASCON_TRACE_ENTER(ASCON_PHASE_FINAL, 0);
+  if (rate == 8) {
+    s->x[1] ^= K0;
+    s->x[2] ^= K1;
+  } else {
+    s->x[2] ^= K0;
+    s->x[3] ^= K1;
+  }
+  printstate("final 1st key xor", s);
+  P12(s);
+  s->x[3] ^= K0;
+  s->x[4] ^= K1;
+  printstate("final 2nd key xor", s);
+  ASCON_TRACE_LEAVE();
+}
+
+/* Ascon-80pq: 160-bit key K = K0 (32 bits) || K1 || K2, otherwise Ascon-128.
+ * The IV shrinks to 32 bits to make room for the extra key word, which also
+ * has to be added in both halves of the initialization and finalization. */
+static inline void ascon80pq_initaead(ascon_state_t* s, uint64_t K0,
+                                      uint64_t K1, uint64_t K2,
+                                      const uint8_t* npub) {
+  ASCON_TRACE_ENTER(ASCON_PHASE_INIT, 0);
+  s->x[0] = ASCON_80PQ_IV | K0;
+  s->x[1] = K1;
+  s->x[2] = K2;
+  s->x[3] = LOADBYTES(npub, 8);
+  s->x[4] = LOADBYTES(npub + 8, 8);
+  printstate("init 1st key xor", s);
+  P12(s);
+  s->x[2] ^= K0;
+  s->x[3] ^= K1;
+  s->x[4] ^= K2;
+  printstate("init 2nd key xor", s);
+  ASCON_TRACE_LEAVE();
+}
+
+static inline void ascon80pq_final(ascon_state_t* s, uint64_t K0, uint64_t K1,
+                                   uint64_t K2) {
+  ASCON_TRACE_ENTER(ASCON_PHASE_FINAL, 0);
+  s->x[1] ^= K0 << 32 | K1 >> 32;
+  s->x[2] ^= K1 << 32 | K2 >> 32;
+  s->x[3] ^= K2 << 32;
+  printstate("final 1st key xor", s);
+  P12(s);
+  s->x[3] ^= K1;
+  s->x[4] ^= K2;
+  printstate("final 2nd key xor", s);
+  ASCON_TRACE_LEAVE();
+}
+
+/* verify should be constant time, check compiler output */
+static inline int ascon_verify(const uint8_t* c, const ascon_state_t* s) {
+  uint8_t t[CRYPTO_ABYTES];
+  STOREBYTES(t, s->x[3], 8);
+  STOREBYTES(t + 8, s->x[4], 8);
+  int i;
+  int result = 0;
+  for (i = 0; i < CRYPTO_ABYTES; ++i) result |= c[i] ^ t[i];
+  return (((result - 1) >> 8) & 1) - 1;
+}
+
+/* In place operation: every block is read before the same bytes are
+ * written, so all encrypt/decrypt functions here (and crypto_aead_* in
+ * aead_updated.c) accept c == m. Partially overlapping buffers are still
+ * not supported, which is what CRYPTO_NOOVERLAP in api.h refers to. */
+
+/* Ascon-128 under its own name, for programs that also link aead.c or
+ * aead_updated.c (which define crypto_aead_* themselves) or need all three
+ * variants; same interface as crypto_aead_encrypt/crypto_aead_decrypt */
+int ascon128_aead_encrypt(unsigned char* c, unsigned long long* clen,
+                          const unsigned char* m, unsigned long long mlen,
+                          const unsigned char* ad, unsigned long long adlen,
+                          const unsigned char* nsec, const unsigned char* npub,
+                          const unsigned char* k);
+
+int ascon128_aead_decrypt(unsigned char* m, unsigned long long* mlen,
+                          unsigned char* nsec, const unsigned char* c,
+                          unsigned long long clen, const unsigned char* ad,
+                          unsigned long long adlen, const unsigned char* npub,
+                          const unsigned char* k);
+
+/* Ascon-128a: same interface */
+int ascon128a_aead_encrypt(unsigned char* c, unsigned long long* clen,
+                           const unsigned char* m, unsigned long long mlen,
+                           const unsigned char* ad, unsigned long long adlen,
+                           const unsigned char* nsec,
+                           const unsigned char* npub, const unsigned char* k);
+
+int ascon128a_aead_decrypt(unsigned char* m, unsigned long long* mlen,
+                           unsigned char* nsec, const unsigned char* c,
+                           unsigned long long clen, const unsigned char* ad,
+                           unsigned long long adlen, const unsigned char* npub,
+                           const unsigned char* k);
+
+/* Ascon-80pq: same interface, k points to ASCON_80PQ_KEYBYTES bytes */
+int ascon80pq_aead_encrypt(unsigned char* c, unsigned long long* clen,
+                           const unsigned char* m, unsigned long long mlen,
+                           const unsigned char* ad, unsigned long long adlen,
+                           const unsigned char* nsec,
+                           const unsigned char* npub, const unsigned char* k);
+
+int ascon80pq_aead_decrypt(unsigned char* m, unsigned long long* mlen,
+                           unsigned char* nsec, const unsigned char* c,
+                           unsigned long long clen, const unsigned char* ad,
+                           unsigned long long adlen, const unsigned char* npub,
+                           const unsigned char* k);
+
+#endif /* ASCON_AEAD_H_ */
@@ -0,0 +1,159 @@
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "ascon.hpp"
+
+extern "C" {
+#include "aead_stream.h"
+#include "ascon_aead.h"
+#include "bench.h"
+}
+
+#define MAX_MSG 80 // several blocks of both rates plus every partial length
+#define MAX_AD 40
+#define MAX_OUT 80 // XOF output lengths
+#define TIMED_BYTES (64 * 1024 * 1024)
+
+// Compares ascon<Variant> with the C streaming code (aead_stream.c) for every message and AD
+// length up to MAX_MSG/MAX_AD, and checks decryption, in-place use and tag rejection
+template <class Variant>
+int check_aead(const char* name, int variant, uint32_t* checksum) {
+    typedef ascon<Variant> A;
+    uint8_t key[A::key_bytes], nonce[A::nonce_bytes], ad[MAX_AD], msg[MAX_MSG];
+    uint8_t expected[MAX_MSG + A::tag_bytes], actual[MAX_MSG + A::tag_bytes], plain[MAX_MSG];
+    int failures = 0;
+
+    for (unsigned i = 0; i < A::key_bytes; i++) key[i] = (uint8_t)i;
+    for (unsigned i = 0; i < A::nonce_bytes; i++) nonce[i] = (uint8_t)(0x80 + i);
+    for (int i = 0; i < MAX_AD; i++) ad[i] = (uint8_t)(0x40 + 3 * i);
+    for (int i = 0; i < MAX_MSG; i++) msg[i] = (uint8_t)(7 * i + 1);
+
+    for (int adlen = 0; adlen <= MAX_AD; adlen++) {
+        for (int mlen = 0; mlen <= MAX_MSG; mlen++) {
+            ascon_aead_ctx_t ctx;
+            ascon_aead_init(&ctx, variant, key, nonce);
+            ascon_aead_update_ad(&ctx, ad, adlen);
+            ascon_aead_encrypt_update(&ctx, expected, msg, mlen);
+            ascon_aead_encrypt_final(&ctx, expected + mlen);
+
+            A::encrypt(actual, actual + mlen, msg, mlen, ad, adlen, nonce, key);
+            if (memcmp(actual, expected, mlen + A::tag_bytes) != 0) {
+                printf("%s: encryption differs (adlen %d, mlen %d)\n", name, adlen, mlen);
+                failures++;
+                continue;
+            }
+            for (unsigned i = 0; i < mlen + A::tag_bytes; i++) {
+                *checksum = (*checksum ^ actual[i]) * 16777619u; // FNV-1a
+            }
+            if (A::decrypt(plain, actual, mlen, actual + mlen, ad, adlen, nonce, key) != 0 ||
+                memcmp(plain, msg, mlen) != 0) {
+                printf("%s: decryption failed (adlen %d, mlen %d)\n", name, adlen, mlen);
+                failures++;
+            }
+            // c == m
+            if (A::decrypt(actual, actual, mlen, actual + mlen, ad, adlen, nonce, key) != 0 ||
+                memcmp(actual, msg, mlen) != 0) {
+                printf("%s: in-place decryption failed (adlen %d, mlen %d)\n", name, adlen, mlen);
+                failures++;
+            }
+            memcpy(actual, expected, mlen + A::tag_bytes);
+            actual[(adlen + mlen) % (mlen + A::tag_bytes)] ^= 0x01;
+            if (A::decrypt(plain, actual, mlen, actual + mlen, ad, adlen, nonce, key) == 0) {
+                printf("%s: modified ciphertext accepted (adlen %d, mlen %d)\n", name, adlen, mlen);
+                failures++;
+            }
+        }
+    }
+    printf("%s: %d of %d cases differ from aead_stream.c\n", name, failures, (MAX_AD + 1) * (MAX_MSG + 1));
+    return failures;
+}
+
+typedef int (*HashFunc)(uint8_t* out, size_t outlen, const uint8_t* in, size_t len);
+
+// Hash and XOF against hash.c for every input length up to MAX_MSG; out_bytes 0 is an XOF
+int check_hash(const char* name, HashFunc reference, HashFunc hash, size_t out_bytes, uint32_t* checksum) {
+    uint8_t msg[MAX_MSG], expected[MAX_OUT], actual[MAX_OUT];
+    int failures = 0;
+
+    for (int i = 0; i < MAX_MSG; i++) msg[i] = (uint8_t)(5 * i + 3);
+    for (int len = 0; len <= MAX_MSG; len++) {
+        size_t outlen = out_bytes ? out_bytes : (size_t)(len % MAX_OUT) + 1;
+        reference(expected, outlen, msg, len);
+        hash(actual, outlen, msg, len);
+        if (memcmp(actual, expected, outlen) != 0) {
+            printf("%s: output differs (length %d)\n", name, len);
+            failures++;
+        }
+        for (size_t i = 0; i < outlen; i++) {
+            *checksum = (*checksum ^ actual[i]) * 16777619u;
+        }
+    }
+    printf("%s: %d of %d cases differ from hash.c\n", name, failures, MAX_MSG + 1);
+    return failures;
+}
+
+// Everything as (out, outlen, in, len) like the XOFs of hash.c
+int ref_hash(uint8_t* out, size_t, const uint8_t* in, size_t len) { return ascon_hash(out, in, len); }
+int ref_hasha(uint8_t* out, size_t, const uint8_t* in, size_t len) { return ascon_hasha(out, in, len); }
+
+template <class Variant>
+int hpp_hash(uint8_t* out, size_t, const uint8_t* in, size_t len) {
+    ascon<Variant>::hash(out, in, len);
+    return 0;
+}
+
+template <class Variant>
+int hpp_xof(uint8_t* out, size_t outlen, const uint8_t* in, size_t len) {
+    ascon<Variant>::xof(out, outlen, in, len);
+    return 0;
+}
+
+typedef int (*AeadEncrypt)(unsigned char*, unsigned long long*, const unsigned char*, unsigned long long,
+                           const unsigned char*, unsigned long long, const unsigned char*,
+                           const unsigned char*, const unsigned char*);
+
+// Time for TIMED_BYTES of message_size-byte messages, in cycles per byte
+double cycles_per_byte(AeadEncrypt encrypt, size_t message_size, uint8_t* buf) {
+    static const uint8_t key[ASCON_80PQ_KEYBYTES] = {0}, nonce[16] = {0};
+    unsigned long long clen;
+    size_t messages = TIMED_BYTES / message_size;
+    encrypt(buf, &clen, buf, message_size, NULL, 0, NULL, nonce, key); // warm up
+    double start = bench_seconds();
+    uint64_t cycles = bench_cycles();
+    for (size_t i = 0; i < messages; i++) {
+        encrypt(buf, &clen, buf, message_size, NULL, 0, NULL, nonce, key);
+    }
+    cycles = bench_cycles() - cycles;
+    double seconds = bench_seconds() - start;
+    return bench_cycles_supported() ? (double)cycles / TIMED_BYTES : seconds * 1e9 / TIMED_BYTES;
+}
+
+int main() {
+    uint32_t checksum = 2166136261u;
+    int failures = 0;
+
+    printf("Checking ascon.hpp\n");
+    failures += check_aead<ascon128>("Ascon-128", ASCON_AEAD_128, &checksum);
+    failures += check_aead<ascon128a>("Ascon-128a", ASCON_AEAD_128A, &checksum);
+    failures += check_aead<ascon80pq>("Ascon-80pq", ASCON_AEAD_80PQ, &checksum);
+    failures += check_hash("Ascon-Hash", ref_hash, hpp_hash<asconhash>, ASCON_HASH_BYTES, &checksum);
+    failures += check_hash("Ascon-Hasha", ref_hasha, hpp_hash<asconhasha>, ASCON_HASH_BYTES, &checksum);
+    failures += check_hash("Ascon-XOF", ascon_xof, hpp_xof<asconxof>, 0, &checksum);
+    failures += check_hash("Ascon-XOFa", ascon_xofa, hpp_xof<asconxofa>, 0, &checksum);
+    printf("Checksum of all outputs: %08lx\n", (unsigned long)checksum);
+    printf(failures ? "FAILED\n" : "OK\n");
+
+    // Same messages through the C functions (ascon_aead.c) and the template
+    static uint8_t buf[1024 * 1024 + 16];
+    static const size_t sizes[] = {64, 1024, 1024 * 1024};
+    printf("\nEncryption, %s per byte (C / ascon.hpp):\n", bench_cycles_supported() ? "cycles" : "ns");
+    for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        printf("%8zu-byte messages: Ascon-128a %.2f / %.2f, Ascon-80pq %.2f / %.2f\n", sizes[i],
+               cycles_per_byte(ascon128a_aead_encrypt, sizes[i], buf),
+               cycles_per_byte(ascon<ascon128a>::aead_encrypt, sizes[i], buf),
+               cycles_per_byte(ascon80pq_aead_encrypt, sizes[i], buf),
+               cycles_per_byte(ascon<ascon80pq>::aead_encrypt, sizes[i], buf));
+    }
+    return failures ? 1 : 0;
+}
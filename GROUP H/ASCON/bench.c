@@ -0,0 +1,318 @@
+#ifndef _WIN32
+#define _GNU_SOURCE /* sched_getaffinity, pthread_setaffinity_np */
+#endif
+
+#include "bench.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <malloc.h>
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#endif
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define BENCH_RDTSC() __rdtsc()
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define BENCH_RDTSC() __rdtsc()
+#endif
+
+#ifdef _WIN32
+#define FETCH_ADD(p, v) InterlockedExchangeAdd((p), (v))
+#define LOAD(p) InterlockedCompareExchange((p), 0, 0)
+#define STORE(p, v) InterlockedExchange((p), (v))
+#define YIELD() SwitchToThread()
+#else
+#define FETCH_ADD(p, v) __atomic_fetch_add((p), (v), __ATOMIC_ACQ_REL)
+#define LOAD(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define YIELD() sched_yield()
+#endif
+
+typedef struct {
+  const bench_config_t* config;
+  bench_thread_t* threads;
+  double start;
+  volatile long ready; /* threads done with setup and warmup */
+  volatile long go;    /* 1: start is set, run; -1: abort */
+} bench_job_t;
+
+typedef struct {
+  bench_job_t* job;
+  bench_thread_t* t;
+} bench_arg_t;
+
+double bench_seconds(void) {
+#ifdef _WIN32
+  LARGE_INTEGER freq, count;
+  QueryPerformanceFrequency(&freq);
+  QueryPerformanceCounter(&count);
+  return (double)count.QuadPart / (double)freq.QuadPart;
+#else
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+#endif
+}
+
+int bench_cycles_supported(void) {
+#ifdef BENCH_RDTSC
+  return 1;
+#else
+  return 0;
+#endif
+}
+
+uint64_t bench_cycles(void) {
+#ifdef BENCH_RDTSC
+  return BENCH_RDTSC();
+#else
+  return 0;
+#endif
+}
+
+int bench_num_cores(void) {
+#ifdef _WIN32
+  SYSTEM_INFO info;
+  GetSystemInfo(&info);
+  return (int)info.dwNumberOfProcessors;
+#else
+  cpu_set_t set;
+  long n;
+  if (sched_getaffinity(0, sizeof(set), &set) == 0 && CPU_COUNT(&set) > 0)
+    return CPU_COUNT(&set);
+  n = sysconf(_SC_NPROCESSORS_ONLN);
+  return n > 0 ? (int)n : 1;
+#endif
+}
+
+static void* bench_alloc(size_t size) {
+  if (!size) return NULL;
+#ifdef _WIN32
+  return _aligned_malloc(size, BENCH_CACHE_LINE);
+#else
+  void* p;
+  return posix_memalign(&p, BENCH_CACHE_LINE, size) ? NULL : p;
+#endif
+}
+
+static void bench_free(void* p) {
+#ifdef _WIN32
+  _aligned_free(p);
+#else
+  free(p);
+#endif
+}
+
+/* pins the calling thread to the n-th usable core (round robin) */
+static int bench_pin(int n) {
+#ifdef _WIN32
+  DWORD_PTR process, system, bit;
+  int cpu;
+  if (!GetProcessAffinityMask(GetCurrentProcess(), &process, &system) ||
+      !process)
+    return -1;
+  n %= bench_num_cores();
+  for (cpu = 0; cpu < (int)(8 * sizeof(DWORD_PTR)); cpu++) {
+    bit = (DWORD_PTR)1 << cpu;
+    if (!(process & bit) || n-- > 0) continue;
+    return SetThreadAffinityMask(GetCurrentThread(), bit) ? cpu : -1;
+  }
+  return -1;
+#else
+  cpu_set_t usable, one;
+  int cpu, count;
+  if (sched_getaffinity(0, sizeof(usable), &usable)) return -1;
+  count = CPU_COUNT(&usable);
+  if (count <= 0) return -1;
+  n %= count;
+  for (cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+    if (!CPU_ISSET(cpu, &usable) || n-- > 0) continue;
+    CPU_ZERO(&one);
+    CPU_SET(cpu, &one);
+    return pthread_setaffinity_np(pthread_self(), sizeof(one), &one) ? -1
+                                                                      : cpu;
+  }
+  return -1;
+#endif
+}
+
+static void* bench_worker(void* args) {
+  bench_arg_t* a = (bench_arg_t*)args;
+  bench_job_t* job = a->job;
+  bench_thread_t* t = a->t;
+  const bench_config_t* config = job->config;
+  uint64_t i;
+  long go;
+  double begin, end = 0;
+
+  t->cpu = config->pin ? bench_pin(t->index) : -1;
+  /* allocated and first written here, after pinning */
+  t->in = (unsigned char*)bench_alloc(config->in_size);
+  t->out = (unsigned char*)bench_alloc(config->out_size);
+  t->latency = (double*)bench_alloc((t->num_units + 1) * sizeof(double));
+  if ((config->in_size && !t->in) || (config->out_size && !t->out) ||
+      !t->latency)
+    t->failed = 1;
+  if (!t->failed) {
+    if (t->in) memset(t->in, 0, config->in_size);
+    if (t->out) memset(t->out, 0, config->out_size);
+    if (config->setup && config->setup(t)) t->failed = 1;
+  }
+  for (i = 0; !t->failed && i < config->warmup_units; i++)
+    config->run(t, t->num_units ? t->first_unit : 0);
+
+  FETCH_ADD(&job->ready, 1);
+  while ((go = LOAD(&job->go)) == 0) YIELD();
+
+  if (go > 0 && !t->failed) {
+    if (config->start) config->start(t);
+    for (i = 0; i < t->num_units; i++) {
+      begin = bench_seconds();
+      t->bytes += config->run(t, t->first_unit + i);
+      end = bench_seconds();
+      t->latency[i] = end - begin;
+    }
+    t->seconds = t->num_units ? end - job->start : 0;
+  }
+  if (config->teardown && !t->failed) config->teardown(t);
+  return NULL;
+}
+
+static int bench_compare(const void* a, const void* b) {
+  double x = *(const double*)a, y = *(const double*)b;
+  return x < y ? -1 : x > y;
+}
+
+/* nearest rank percentile of n sorted values */
+static double bench_percentile(const double* v, uint64_t n, int p) {
+  uint64_t rank;
+  if (!n) return 0;
+  rank = (n * p + 99) / 100;
+  return v[rank ? rank - 1 : 0];
+}
+
+static void bench_summarize(bench_job_t* job, bench_result_t* result,
+                            double* thread_throughput) {
+  const bench_config_t* config = job->config;
+  double* all = (double*)malloc((config->units + 1) * sizeof(double));
+  uint64_t n = 0, i;
+  int k, first = 1;
+
+  memset(result, 0, sizeof(*result));
+  result->num_threads = config->num_threads;
+  result->units = config->units;
+  for (k = 0; k < config->num_threads; k++) {
+    bench_thread_t* t = &job->threads[k];
+    double rate = t->seconds > 0 ? t->bytes / t->seconds : 0;
+    if (thread_throughput) thread_throughput[k] = rate;
+    if (t->num_units) {
+      if (result->wall_seconds < t->seconds) result->wall_seconds = t->seconds;
+      if (first || rate < result->min_thread_throughput)
+        result->min_thread_throughput = rate;
+      first = 0;
+      if (rate > result->max_thread_throughput)
+        result->max_thread_throughput = rate;
+    }
+    result->bytes += t->bytes;
+    for (i = 0; all && i < t->num_units; i++) all[n++] = t->latency[i];
+  }
+  if (result->wall_seconds > 0)
+    result->throughput = result->bytes / result->wall_seconds;
+  if (all) {
+    qsort(all, n, sizeof(double), bench_compare);
+    result->p50_latency = bench_percentile(all, n, 50);
+    result->p99_latency = bench_percentile(all, n, 99);
+    free(all);
+  }
+}
+
+int bench_run(const bench_config_t* config, bench_result_t* result,
+              double* thread_throughput) {
+  int n = config->num_threads > 0 ? config->num_threads : 1;
+  bench_config_t c = *config;
+  bench_job_t job;
+  bench_arg_t* args;
+  int i, started, failed = 0;
+#ifdef _WIN32
+  HANDLE* threads;
+#else
+  pthread_t* threads;
+#endif
+
+  c.num_threads = n;
+  memset(&job, 0, sizeof(job));
+  job.config = &c;
+  job.threads = (bench_thread_t*)bench_alloc(n * sizeof(bench_thread_t));
+  args = (bench_arg_t*)malloc(n * sizeof(bench_arg_t));
+  threads = malloc(n * sizeof(*threads));
+  if (!job.threads || !args || !threads) {
+    bench_free(job.threads);
+    free(args);
+    free(threads);
+    return -1;
+  }
+  memset(job.threads, 0, n * sizeof(bench_thread_t));
+  for (i = 0; i < n; i++) {
+    bench_thread_t* t = &job.threads[i];
+    t->config = &c;
+    t->index = i;
+    t->first_unit = c.units * i / n;
+    t->num_units = c.units * (i + 1) / n - t->first_unit;
+    args[i].job = &job;
+    args[i].t = t;
+  }
+
+  for (started = 0; started < n; started++) {
+#ifdef _WIN32
+    threads[started] =
+        CreateThread(NULL, 0, (LPTHREAD_START_ROUTINE)bench_worker,
+                     &args[started], 0, NULL);
+    if (!threads[started]) break;
+#else
+    if (pthread_create(&threads[started], NULL, bench_worker, &args[started]))
+      break;
+#endif
+  }
+  while (LOAD(&job.ready) < started) YIELD();
+  for (i = 0; i < started; i++) failed |= job.threads[i].failed;
+  if (started < n || failed) {
+    failed = 1;
+    STORE(&job.go, -1);
+  } else {
+    job.start = bench_seconds();
+    STORE(&job.go, 1);
+  }
+#ifdef _WIN32
+  WaitForMultipleObjects(started, threads, TRUE, INFINITE);
+  for (i = 0; i < started; i++) CloseHandle(threads[i]);
+#else
+  for (i = 0; i < started; i++) pthread_join(threads[i], NULL);
+#endif
+
+  if (!failed) bench_summarize(&job, result, thread_throughput);
+  for (i = 0; i < started; i++) {
+    bench_free(job.threads[i].in);
+    bench_free(job.threads[i].out);
+    bench_free(job.threads[i].latency);
+  }
+  bench_free(job.threads);
+  free(args);
+  free(threads);
+  return failed ? -1 : 0;
+}
+
+int bench_thread_counts(int max_threads, int* counts) {
+  int n = 0, t;
+  for (t = 1; t < max_threads && n < 31; t *= 2) counts[n++] = t;
+  counts[n++] = max_threads > 0 ? max_threads : 1;
+  return n;
+}
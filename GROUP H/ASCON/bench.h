@@ -0,0 +1,95 @@
+#ifndef BENCH_H_
+#define BENCH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Multithreaded benchmark engine. config->units work units are split into
+ * contiguous ranges, one per thread. Every thread
+ *
+ *   1. pins itself to a core (thread i to the i-th usable core),
+ *   2. allocates its own cache line aligned in/out buffers and calls setup,
+ *      which writes them first, so their pages come from the memory node of
+ *      that core (first touch) and no cache line is shared with another
+ *      thread,
+ *   3. runs warmup_units untimed units,
+ *   4. waits until all threads are ready and then runs its units, timing
+ *      every unit on the wall clock.
+ *
+ * Wall time is measured from the common start to the last thread's last
+ * unit, so thread creation, allocation, setup and warmup are not counted. */
+
+#define BENCH_CACHE_LINE 64
+
+typedef struct bench_thread_s bench_thread_t;
+
+typedef struct {
+  int num_threads;
+  uint64_t units;        /* timed units of all threads together */
+  uint64_t warmup_units; /* untimed units per thread */
+  size_t in_size;        /* per-thread buffer sizes, may be 0 */
+  size_t out_size;
+  int pin;               /* nonzero: pin threads to cores */
+  /* optional, on the worker thread after allocation; nonzero aborts */
+  int (*setup)(bench_thread_t* t);
+  /* optional, on the worker thread right before its first timed unit */
+  void (*start)(bench_thread_t* t);
+  /* process one unit (an index in [0, units)), return the bytes done */
+  uint64_t (*run)(bench_thread_t* t, uint64_t unit);
+  /* optional, on the worker thread after the last unit */
+  void (*teardown)(bench_thread_t* t);
+  void* arg; /* for the callbacks */
+} bench_config_t;
+
+struct bench_thread_s {
+  const bench_config_t* config;
+  int index;
+  int cpu; /* core the thread is pinned to, -1 if not pinned */
+  unsigned char* in;
+  unsigned char* out;
+  uint64_t first_unit;
+  uint64_t num_units;
+  void* user; /* free for the callbacks */
+  /* results */
+  uint64_t bytes;
+  double seconds;   /* common start to the end of this thread's last unit */
+  double* latency;  /* seconds of each of its units */
+  int failed;
+  char pad[BENCH_CACHE_LINE];
+};
+
+typedef struct {
+  int num_threads;
+  uint64_t units;
+  uint64_t bytes;
+  double wall_seconds;
+  double throughput;     /* bytes per second, all threads */
+  double min_thread_throughput;
+  double max_thread_throughput;
+  double p50_latency;    /* seconds per unit over all threads */
+  double p99_latency;
+} bench_result_t;
+
+/* monotonic wall clock in seconds */
+double bench_seconds(void);
+
+/* CPU timestamp counter (rdtsc on x86, which counts at the nominal clock
+ * rate); bench_cycles_supported() is 0 and bench_cycles() returns 0 where
+ * there is none */
+int bench_cycles_supported(void);
+uint64_t bench_cycles(void);
+
+/* usable cores (the process affinity mask where there is one) */
+int bench_num_cores(void);
+
+/* Runs the benchmark and fills result. thread_throughput (bytes per second
+ * of each thread) may be NULL. Returns 0, or -1 if a thread could not be
+ * started or a setup failed. */
+int bench_run(const bench_config_t* config, bench_result_t* result,
+              double* thread_throughput);
+
+/* 1, 2, 4, ... up to max_threads, plus max_threads itself; returns how many
+ * counts were written (at most 32) */
+int bench_thread_counts(int max_threads, int* counts);
+
+#endif /* BENCH_H_ */
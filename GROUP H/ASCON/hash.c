@@ -0,0 +1,139 @@
+#include "hash.h"
+
+#include <string.h>
+
+#include "ascon.h"
+#include "constants.h"
+#include "permutations.h"
+#include "printstate.h"
+#include "word.h"
+
+/* permutation between absorbed and squeezed blocks: pB */
+static inline void PB(ascon_state_t* s, int rounds) {
+  if (rounds == 8)
+    P8(s);
+  else
+    P12(s);
+}
+
+static void ascon_hash_initialize(ascon_hash_ctx_t* ctx, uint64_t iv,
+                                  int pb_rounds) {
+  ctx->s.x[0] = iv;
+  ctx->s.x[1] = 0;
+  ctx->s.x[2] = 0;
+  ctx->s.x[3] = 0;
+  ctx->s.x[4] = 0;
+  printstate("initial value", &ctx->s);
+  P12(&ctx->s);
+  printstate("initialization", &ctx->s);
+  ctx->buflen = 0;
+  ctx->pb_rounds = pb_rounds;
+  ctx->squeezing = 0;
+}
+
+void ascon_hash_init(ascon_hash_ctx_t* ctx) {
+  ascon_hash_initialize(ctx, ASCON_HASH_IV, ASCON_HASH_PB_ROUNDS);
+}
+
+void ascon_hasha_init(ascon_hash_ctx_t* ctx) {
+  ascon_hash_initialize(ctx, ASCON_HASHA_IV, ASCON_HASHA_PB_ROUNDS);
+}
+
+void ascon_xof_init(ascon_hash_ctx_t* ctx) {
+  ascon_hash_initialize(ctx, ASCON_XOF_IV, ASCON_HASH_PB_ROUNDS);
+}
+
+void ascon_xofa_init(ascon_hash_ctx_t* ctx) {
+  ascon_hash_initialize(ctx, ASCON_XOFA_IV, ASCON_HASHA_PB_ROUNDS);
+}
+
+void ascon_hash_update(ascon_hash_ctx_t* ctx, const uint8_t* in, size_t len) {
+  /* complete a buffered block */
+  if (ctx->buflen) {
+    size_t n = ASCON_HASH_RATE - ctx->buflen;
+    if (n > len) n = len;
+    memcpy(ctx->buf + ctx->buflen, in, n);
+    ctx->buflen += (int)n;
+    in += n;
+    len -= n;
+    if (ctx->buflen < ASCON_HASH_RATE) return;
+    ctx->s.x[0] ^= LOADBYTES(ctx->buf, 8);
+    printstate("absorb plaintext", &ctx->s);
+    PB(&ctx->s, ctx->pb_rounds);
+    ctx->buflen = 0;
+  }
+  /* full plaintext blocks */
+  while (len >= ASCON_HASH_RATE) {
+    ctx->s.x[0] ^= LOADBYTES(in, 8);
+    printstate("absorb plaintext", &ctx->s);
+    PB(&ctx->s, ctx->pb_rounds);
+    in += ASCON_HASH_RATE;
+    len -= ASCON_HASH_RATE;
+  }
+  /* keep the rest for the next call */
+  memcpy(ctx->buf, in, len);
+  ctx->buflen = (int)len;
+}
+
+void ascon_xof_squeeze(ascon_hash_ctx_t* ctx, uint8_t* out, size_t len) {
+  if (!ctx->squeezing) {
+    /* final plaintext block */
+    ctx->s.x[0] ^= LOADBYTES(ctx->buf, ctx->buflen);
+    ctx->s.x[0] ^= PAD(ctx->buflen);
+    printstate("pad plaintext", &ctx->s);
+    P12(&ctx->s);
+    printstate("finalization", &ctx->s);
+    ctx->squeezing = 1;
+    ctx->buflen = 0; /* now: bytes of x[0] already squeezed */
+  }
+  while (len) {
+    size_t n;
+    if (ctx->buflen == ASCON_HASH_RATE) {
+      PB(&ctx->s, ctx->pb_rounds);
+      printstate("squeeze output", &ctx->s);
+      ctx->buflen = 0;
+    }
+    n = ASCON_HASH_RATE - ctx->buflen;
+    if (n > len) n = len;
+    STOREBYTES(out, ctx->s.x[0] << (8 * ctx->buflen), (int)n);
+    ctx->buflen += (int)n;
+    out += n;
+    len -= n;
+  }
+}
+
+void ascon_hash_final(ascon_hash_ctx_t* ctx, uint8_t* out) {
+  ascon_xof_squeeze(ctx, out, ASCON_HASH_BYTES);
+}
+
+int ascon_hash(uint8_t* out, const uint8_t* in, size_t len) {
+  ascon_hash_ctx_t ctx;
+  ascon_hash_init(&ctx);
+  ascon_hash_update(&ctx, in, len);
+  ascon_hash_final(&ctx, out);
+  return 0;
+}
+
+int ascon_hasha(uint8_t* out, const uint8_t* in, size_t len) {
+  ascon_hash_ctx_t ctx;
+  ascon_hasha_init(&ctx);
+  ascon_hash_update(&ctx, in, len);
+  ascon_hash_final(&ctx, out);
+  return 0;
+}
+
+int ascon_xof(uint8_t* out, size_t outlen, const uint8_t* in, size_t len) {
+  ascon_hash_ctx_t ctx;
+  ascon_xof_init(&ctx);
+  ascon_hash_update(&ctx, in, len);
+  ascon_xof_squeeze(&ctx, out, outlen);
+  return 0;
+}
+
+int ascon_xofa(uint8_t* out, size_t outlen, const uint8_t* in, size_t len) {
+  ascon_hash_ctx_t ctx;
+  ascon_xofa_init(&ctx);
+  ascon_hash_update(&ctx, in, len);
+  ascon_xof_squeeze(&ctx, out, outlen);
+  return 0;
+}
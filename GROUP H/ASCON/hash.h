@@ -0,0 +1,40 @@
+#ifndef HASH_H_
+#define HASH_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "ascon.h"
+
+#define ASCON_HASH_BYTES 32
+
+/* streaming state shared by Ascon-Hash, Ascon-Hasha, Ascon-XOF, Ascon-XOFa */
+typedef struct {
+  ascon_state_t s;
+  uint8_t buf[8]; /* partial ASCON_HASH_RATE block */
+  int buflen;
+  int pb_rounds; /* 12 for Hash/XOF, 8 for Hasha/XOFa */
+  int squeezing;
+} ascon_hash_ctx_t;
+
+void ascon_hash_init(ascon_hash_ctx_t* ctx);
+void ascon_hasha_init(ascon_hash_ctx_t* ctx);
+void ascon_xof_init(ascon_hash_ctx_t* ctx);
+void ascon_xofa_init(ascon_hash_ctx_t* ctx);
+
+/* absorb input, any number of calls and lengths */
+void ascon_hash_update(ascon_hash_ctx_t* ctx, const uint8_t* in, size_t len);
+
+/* Ascon-Hash/Hasha: write the ASCON_HASH_BYTES digest */
+void ascon_hash_final(ascon_hash_ctx_t* ctx, uint8_t* out);
+
+/* Ascon-XOF/XOFa: produce output, may be called repeatedly */
+void ascon_xof_squeeze(ascon_hash_ctx_t* ctx, uint8_t* out, size_t len);
+
+/* single-call interfaces */
+int ascon_hash(uint8_t* out, const uint8_t* in, size_t len);
+int ascon_hasha(uint8_t* out, const uint8_t* in, size_t len);
+int ascon_xof(uint8_t* out, size_t outlen, const uint8_t* in, size_t len);
+int ascon_xofa(uint8_t* out, size_t outlen, const uint8_t* in, size_t len);
+
+#endif /* HASH_H_ */
@@ -0,0 +1,170 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "hash.h"
+#include "bench.h"
+#include "rapl.h"
+#include "testdata.h"
+#include "sha2.h"
+#include "sha3.h"
+
+#define CHUNK_SIZE (1 * 1024 * 1024) // 1 MB
+#define SHORT_MSG_SIZE 64             // Typical packet-sized message
+#define SHORT_MSG_CALLS 100000
+
+typedef struct {
+    const char* name;
+    void (*bulk)(const unsigned char* data, unsigned long long chunks, unsigned char* digest);
+    void (*oneshot)(const unsigned char* data, size_t len, unsigned char* digest);
+} HashAlgorithm;
+
+void ascon_hash_bulk(const unsigned char* data, unsigned long long chunks, unsigned char* digest) {
+    ascon_hash_ctx_t ctx;
+    ascon_hash_init(&ctx);
+    for (unsigned long long i = 0; i < chunks; i++) {
+        ascon_hash_update(&ctx, data, CHUNK_SIZE);
+    }
+    ascon_hash_final(&ctx, digest);
+}
+
+void ascon_hasha_bulk(const unsigned char* data, unsigned long long chunks, unsigned char* digest) {
+    ascon_hash_ctx_t ctx;
+    ascon_hasha_init(&ctx);
+    for (unsigned long long i = 0; i < chunks; i++) {
+        ascon_hash_update(&ctx, data, CHUNK_SIZE);
+    }
+    ascon_hash_final(&ctx, digest);
+}
+
+void ascon_xof_bulk(const unsigned char* data, unsigned long long chunks, unsigned char* digest) {
+    ascon_hash_ctx_t ctx;
+    ascon_xof_init(&ctx);
+    for (unsigned long long i = 0; i < chunks; i++) {
+        ascon_hash_update(&ctx, data, CHUNK_SIZE);
+    }
+    ascon_xof_squeeze(&ctx, digest, 32);
+}
+
+void ascon_xofa_bulk(const unsigned char* data, unsigned long long chunks, unsigned char* digest) {
+    ascon_hash_ctx_t ctx;
+    ascon_xofa_init(&ctx);
+    for (unsigned long long i = 0; i < chunks; i++) {
+        ascon_hash_update(&ctx, data, CHUNK_SIZE);
+    }
+    ascon_xof_squeeze(&ctx, digest, 32);
+}
+
+void sha256_bulk(const unsigned char* data, unsigned long long chunks, unsigned char* digest) {
+    sha256_ctx ctx;
+    sha256_init(&ctx);
+    for (unsigned long long i = 0; i < chunks; i++) {
+        sha256_update(&ctx, data, CHUNK_SIZE);
+    }
+    sha256_final(&ctx, digest);
+}
+
+void sha3_256_bulk(const unsigned char* data, unsigned long long chunks, unsigned char* digest) {
+    sha3_context ctx;
+    sha3_Init256(&ctx);
+    for (unsigned long long i = 0; i < chunks; i++) {
+        sha3_Update(&ctx, data, CHUNK_SIZE);
+    }
+    memcpy(digest, sha3_Finalize(&ctx), 32);
+}
+
+void ascon_hash_oneshot(const unsigned char* data, size_t len, unsigned char* digest) {
+    ascon_hash(digest, data, len);
+}
+
+void ascon_hasha_oneshot(const unsigned char* data, size_t len, unsigned char* digest) {
+    ascon_hasha(digest, data, len);
+}
+
+void ascon_xof_oneshot(const unsigned char* data, size_t len, unsigned char* digest) {
+    ascon_xof(digest, 32, data, len);
+}
+
+void ascon_xofa_oneshot(const unsigned char* data, size_t len, unsigned char* digest) {
+    ascon_xofa(digest, 32, data, len);
+}
+
+void sha256_oneshot(const unsigned char* data, size_t len, unsigned char* digest) {
+    sha256(data, len, digest);
+}
+
+void sha3_256_oneshot(const unsigned char* data, size_t len, unsigned char* digest) {
+    sha3_HashBuffer(256, SHA3_FLAGS_NONE, data, (unsigned)len, digest, 32);
+}
+
+static const HashAlgorithm algorithms[] = {
+    { "Ascon-Hash", ascon_hash_bulk, ascon_hash_oneshot },
+    { "Ascon-Hasha", ascon_hasha_bulk, ascon_hasha_oneshot },
+    { "Ascon-XOF", ascon_xof_bulk, ascon_xof_oneshot },
+    { "Ascon-XOFa", ascon_xofa_bulk, ascon_xofa_oneshot },
+    { "SHA-256", sha256_bulk, sha256_oneshot },
+    { "SHA3-256", sha3_256_bulk, sha3_256_oneshot },
+};
+
+// rapl: NULL if the energy counter cannot be read
+void benchmark_hash(const HashAlgorithm* alg, const unsigned char* data, unsigned long long total_size, const rapl_t* rapl) {
+    unsigned char digest[32];
+    unsigned long long chunks = total_size / CHUNK_SIZE;
+    uint64_t energy_before = 0, energy_after = 0;
+    int have_energy = rapl && rapl_read(rapl, &energy_before) == 0;
+
+    double start = bench_seconds();
+    alg->bulk(data, chunks, digest);
+    double elapsed_time = bench_seconds() - start;
+    double throughput = (double)total_size / (1024 * 1024) / elapsed_time;
+    have_energy = have_energy && rapl_read(rapl, &energy_after) == 0;
+
+    start = bench_seconds();
+    for (int i = 0; i < SHORT_MSG_CALLS; i++) {
+        alg->oneshot(data + (i & 255), SHORT_MSG_SIZE, digest);
+    }
+    double short_time = bench_seconds() - start;
+
+    printf("%-12s %10.3f s %12.3f MB/s %12.1f ns per %d-byte message",
+        alg->name, elapsed_time, throughput,
+        short_time * 1e9 / SHORT_MSG_CALLS, SHORT_MSG_SIZE);
+    if (have_energy) {
+        printf(" %10.3f nJ/byte", rapl_active_uj(rapl, energy_before, energy_after, elapsed_time) * 1e3 / total_size);
+    }
+    printf("\n");
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <total_size_in_MB>\n", argv[0]);
+        return 1;
+    }
+
+    unsigned long long total_size_in_mb = atoi(argv[1]);
+    unsigned long long total_size = total_size_in_mb * 1024 * 1024;
+
+    unsigned char* input_data = malloc(CHUNK_SIZE);
+    if (!input_data) {
+        perror("Memory allocation failed");
+        return 1;
+    }
+    testdata_bytes(TESTDATA_MESSAGE, input_data, CHUNK_SIZE);
+
+    // Energy of the bulk run above the idle power of the package
+    rapl_t rapl;
+    int have_rapl = rapl_open(&rapl) == 0 && rapl_measure_idle(&rapl, RAPL_IDLE_MS) == 0;
+    if (have_rapl) {
+        printf("Energy: RAPL %s, idle %.0f mW subtracted\n", rapl.zone, rapl.idle_mw);
+    } else {
+        printf("Energy: no RAPL access, no nJ/byte figures\n");
+    }
+
+    printf("Hashing %llu MB per algorithm...\n", total_size_in_mb);
+    for (size_t i = 0; i < sizeof(algorithms) / sizeof(algorithms[0]); i++) {
+        benchmark_hash(&algorithms[i], input_data, total_size, have_rapl ? &rapl : NULL);
+    }
+
+    free(input_data);
+    return 0;
+}
@@ -0,0 +1,138 @@
+#include "nonce.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+/* counter values are 64 bits, so there are 2^44 blocks */
+#define MAX_BLOCKS ((int64_t)1 << (64 - ASCON_NONCE_BLOCK_BITS))
+
+#ifdef _WIN32
+#define FETCH_ADD(p, v) InterlockedExchangeAdd64((p), (v))
+#define LOAD(p) InterlockedCompareExchange64((p), 0, 0)
+#define STORE(p, v) InterlockedExchange64((p), (v))
+#define LOCK(m) EnterCriticalSection(&(m)->lock)
+#define UNLOCK(m) LeaveCriticalSection(&(m)->lock)
+#else
+#define FETCH_ADD(p, v) __atomic_fetch_add((p), (v), __ATOMIC_RELAXED)
+#define LOAD(p) __atomic_load_n((p), __ATOMIC_ACQUIRE)
+#define STORE(p, v) __atomic_store_n((p), (v), __ATOMIC_RELEASE)
+#define LOCK(m) pthread_mutex_lock(&(m)->lock)
+#define UNLOCK(m) pthread_mutex_unlock(&(m)->lock)
+#endif
+
+static int read_mark(const char* path, int64_t* mark) {
+  uint8_t b[8];
+  FILE* f = fopen(path, "rb");
+  int i;
+  *mark = 0;
+  if (!f) return 0; /* first run */
+  if (fread(b, 1, 8, f) != 8) {
+    fclose(f);
+    return -1;
+  }
+  fclose(f);
+  for (i = 0; i < 8; i++) *mark = *mark << 8 | b[i];
+  return *mark < 0 || *mark > MAX_BLOCKS ? -1 : 0;
+}
+
+/* write to path.tmp, sync, then rename over path */
+static int write_mark(const char* path, int64_t mark) {
+  char tmp[1024];
+  uint8_t b[8];
+  FILE* f;
+  int i, ok;
+  if (strlen(path) + 5 > sizeof(tmp)) return -1;
+  strcpy(tmp, path);
+  strcat(tmp, ".tmp");
+  for (i = 0; i < 8; i++) b[i] = (uint8_t)(mark >> (56 - 8 * i));
+  f = fopen(tmp, "wb");
+  if (!f) return -1;
+  ok = fwrite(b, 1, 8, f) == 8 && fflush(f) == 0;
+#ifdef _WIN32
+  ok = ok && FlushFileBuffers((HANDLE)_get_osfhandle(_fileno(f)));
+#else
+  ok = ok && fsync(fileno(f)) == 0;
+#endif
+  ok = fclose(f) == 0 && ok;
+  if (!ok) return -1;
+#ifdef _WIN32
+  return MoveFileExA(tmp, path, MOVEFILE_REPLACE_EXISTING |
+                                    MOVEFILE_WRITE_THROUGH)
+             ? 0
+             : -1;
+#else
+  return rename(tmp, path) ? -1 : 0;
+#endif
+}
+
+int ascon_nonce_init(ascon_nonce_mgr_t* mgr, const uint8_t* prefix,
+                     const char* state_path) {
+  int64_t mark = 0;
+  memcpy(mgr->prefix, prefix, ASCON_NONCE_PREFIX_BYTES);
+  mgr->state_path = state_path;
+  if (state_path && read_mark(state_path, &mark)) return -1;
+  mgr->next_block = mark;
+  mgr->limit = state_path ? mark : MAX_BLOCKS;
+#ifdef _WIN32
+  InitializeCriticalSection(&mgr->lock);
+#else
+  pthread_mutex_init(&mgr->lock, NULL);
+#endif
+  return 0;
+}
+
+void ascon_nonce_destroy(ascon_nonce_mgr_t* mgr) {
+#ifdef _WIN32
+  DeleteCriticalSection(&mgr->lock);
+#else
+  pthread_mutex_destroy(&mgr->lock);
+#endif
+}
+
+void ascon_nonce_thread_init(ascon_nonce_ctx_t* ctx, ascon_nonce_mgr_t* mgr) {
+  ctx->mgr = mgr;
+  ctx->next = 0;
+  ctx->end = 0;
+}
+
+/* make sure block is below the persisted high-water mark */
+static int persist(ascon_nonce_mgr_t* mgr, int64_t block) {
+  int result = 0;
+  LOCK(mgr);
+  if (mgr->limit <= block) {
+    int64_t mark = block + ASCON_NONCE_PERSIST_BLOCKS;
+    if (mark > MAX_BLOCKS) mark = MAX_BLOCKS;
+    result = write_mark(mgr->state_path, mark);
+    if (!result) STORE(&mgr->limit, mark);
+  }
+  UNLOCK(mgr);
+  return result;
+}
+
+static int reserve(ascon_nonce_ctx_t* ctx) {
+  ascon_nonce_mgr_t* mgr = ctx->mgr;
+  int64_t block = FETCH_ADD(&mgr->next_block, 1);
+  if (block >= MAX_BLOCKS) return -1;
+  if (block >= LOAD(&mgr->limit) && persist(mgr, block)) return -1;
+  ctx->next = (uint64_t)block << ASCON_NONCE_BLOCK_BITS;
+  ctx->end = ctx->next + ASCON_NONCE_BLOCK;
+  return 0;
+}
+
+int ascon_nonce_next(ascon_nonce_ctx_t* ctx, uint8_t* nonce) {
+  uint64_t n;
+  int i;
+  /* end == 0 also covers the wrap of the very last block */
+  if (ctx->next == ctx->end && reserve(ctx)) return -1;
+  n = ctx->next++;
+  memcpy(nonce, ctx->mgr->prefix, ASCON_NONCE_PREFIX_BYTES);
+  for (i = 0; i < 8; i++)
+    nonce[ASCON_NONCE_PREFIX_BYTES + i] = (uint8_t)(n >> (56 - 8 * i));
+  return 0;
+}
@@ -0,0 +1,61 @@
+#ifndef NONCE_H_
+#define NONCE_H_
+
+#include <stdint.h>
+
+#include "api.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+/* Nonces are prefix (8 bytes) || counter (64-bit big-endian). Threads
+ * reserve blocks of ASCON_NONCE_BLOCK counter values with one atomic
+ * fetch-add and then count inside their block without any shared state,
+ * so contention is one atomic operation per 2^20 nonces per thread.
+ *
+ * With a state file, a high-water mark (in blocks) is written and synced
+ * before any nonce below it is handed out, ASCON_NONCE_PERSIST_BLOCKS
+ * blocks at a time. After a restart counting resumes at that mark, so
+ * nonces that were reserved but never used are skipped, never reused. */
+
+#define ASCON_NONCE_PREFIX_BYTES 8
+#define ASCON_NONCE_BLOCK_BITS 20
+#define ASCON_NONCE_BLOCK ((uint64_t)1 << ASCON_NONCE_BLOCK_BITS)
+#define ASCON_NONCE_PERSIST_BLOCKS 64
+
+typedef struct {
+  uint8_t prefix[ASCON_NONCE_PREFIX_BYTES];
+  volatile int64_t next_block; /* next block to reserve, atomic */
+  volatile int64_t limit;      /* blocks below this are on disk */
+  const char* state_path;      /* NULL: no persistence */
+#ifdef _WIN32
+  CRITICAL_SECTION lock;
+#else
+  pthread_mutex_t lock; /* only taken to move the high-water mark */
+#endif
+} ascon_nonce_mgr_t;
+
+/* one per thread */
+typedef struct {
+  ascon_nonce_mgr_t* mgr;
+  uint64_t next;
+  uint64_t end;
+} ascon_nonce_ctx_t;
+
+/* Use one prefix per key (random, or a device id). If state_path exists,
+ * counting continues after the mark stored there. Returns -1 if the state
+ * file cannot be read or written. */
+int ascon_nonce_init(ascon_nonce_mgr_t* mgr, const uint8_t* prefix,
+                     const char* state_path);
+void ascon_nonce_destroy(ascon_nonce_mgr_t* mgr);
+
+void ascon_nonce_thread_init(ascon_nonce_ctx_t* ctx, ascon_nonce_mgr_t* mgr);
+
+/* Writes the next CRYPTO_NPUBBYTES nonce of this thread. Returns -1 if the
+ * counter space is exhausted or the high-water mark cannot be saved. */
+int ascon_nonce_next(ascon_nonce_ctx_t* ctx, uint8_t* nonce);
+
+#endif /* NONCE_H_ */
@@ -0,0 +1,153 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "aead_batch.h"
+#include "ascon_aead.h"
+#include "bench.h"
+#include "rapl.h"
+#include "testdata.h"
+
+#define NUM_PACKETS 65536   // Packets kept in memory, reused every pass
+#define MIN_PACKET 32
+#define MAX_PACKET 256
+#define AD_SIZE 8           // e.g. a sequence number
+#define NUM_SESSIONS 1000
+
+// Per-packet decryption as crypto_aead_decrypt does it: parse the key every time
+int decrypt_one(int variant, const unsigned char* key, ascon_packet_t* p) {
+    unsigned long long mlen;
+    if (variant == ASCON_AEAD_128A) {
+        return ascon128a_aead_decrypt(p->out, &mlen, NULL, p->in, p->inlen, p->ad, p->adlen, p->npub, key);
+    }
+    if (variant == ASCON_AEAD_80PQ) {
+        return ascon80pq_aead_decrypt(p->out, &mlen, NULL, p->in, p->inlen, p->ad, p->adlen, p->npub, key);
+    }
+    return ascon128_aead_decrypt(p->out, &mlen, NULL, p->in, p->inlen, p->ad, p->adlen, p->npub, key);
+}
+
+// Ends a result line with the energy per payload byte above idle since the reading before, if any
+void print_energy(const rapl_t* rapl, uint64_t before, double seconds, double bytes) {
+    uint64_t after;
+    if (rapl && rapl_read(rapl, &after) == 0) {
+        printf(", %.3f nJ/byte", rapl_active_uj(rapl, before, after, seconds) * 1e3 / bytes);
+    }
+    printf("\n");
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2) {
+        fprintf(stderr, "Usage: %s <millions_of_packets> [variant: 0=Ascon-128, 1=Ascon-128a, 2=Ascon-80pq]\n", argv[0]);
+        return 1;
+    }
+
+    double total_packets = atof(argv[1]) * 1e6;
+    int variant = argc > 2 ? atoi(argv[2]) : ASCON_AEAD_128A;
+    int passes = (int)(total_packets / NUM_PACKETS);
+    if (passes < 1) {
+        passes = 1;
+    }
+
+    // Sessions with random keys, packets of random length and session
+    unsigned char (*keys)[ASCON_80PQ_KEYBYTES] = malloc(NUM_SESSIONS * sizeof(*keys));
+    ascon_session_t* sessions = malloc(NUM_SESSIONS * sizeof(ascon_session_t));
+    ascon_packet_t* packets = malloc(NUM_PACKETS * sizeof(ascon_packet_t));
+    int* owner = malloc(NUM_PACKETS * sizeof(int));
+    unsigned char* data = malloc((size_t)NUM_PACKETS * (MAX_PACKET + CRYPTO_ABYTES + CRYPTO_NPUBBYTES + AD_SIZE));
+    unsigned char* plain = malloc((size_t)NUM_PACKETS * (MAX_PACKET + CRYPTO_ABYTES));
+    if (!keys || !sessions || !packets || !owner || !data || !plain) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+
+    // Keys, packet contents, lengths and owners from separate reproducible streams
+    testdata_stream_t stream;
+    uint64_t offset = 0;
+    unsigned char* draws = malloc(4 * NUM_PACKETS); // 16-bit length and owner draws per packet
+    if (!draws) {
+        fprintf(stderr, "Out of memory\n");
+        return 1;
+    }
+    testdata_bytes(TESTDATA_KEY, keys, NUM_SESSIONS * sizeof(*keys));
+    testdata_bytes(TESTDATA_THREAD(0), draws, 4 * NUM_PACKETS);
+    testdata_stream(&stream, testdata_seed(), TESTDATA_MESSAGE);
+    for (int i = 0; i < NUM_SESSIONS; i++) {
+        if (ascon_session_init(&sessions[i], variant, keys[i])) {
+            fprintf(stderr, "Unknown variant %d\n", variant);
+            return 1;
+        }
+    }
+    unsigned char* p = data;
+    double payload_bytes = 0; // per pass
+    for (int i = 0; i < NUM_PACKETS; i++) {
+        size_t len = MIN_PACKET + (draws[4 * i] << 8 | draws[4 * i + 1]) % (MAX_PACKET - MIN_PACKET + 1);
+        payload_bytes += len;
+        unsigned char* npub = p;
+        unsigned char* ad = npub + CRYPTO_NPUBBYTES;
+        unsigned char* ct = ad + AD_SIZE;
+        testdata_fill(&stream, offset, p, CRYPTO_NPUBBYTES + AD_SIZE + len);
+        offset += CRYPTO_NPUBBYTES + AD_SIZE + len;
+        owner[i] = (draws[4 * i + 2] << 8 | draws[4 * i + 3]) % NUM_SESSIONS;
+        packets[i] = (ascon_packet_t){
+            .session = &sessions[owner[i]],
+            .npub = npub,
+            .ad = ad,
+            .adlen = AD_SIZE,
+            .in = ct,
+            .inlen = len,
+            .out = ct,
+        };
+        p = ct + len + CRYPTO_ABYTES;
+    }
+    free(draws);
+    ascon_encrypt_batch(packets, NUM_PACKETS);
+
+    // Decrypt into a separate buffer from now on
+    for (int i = 0; i < NUM_PACKETS; i++) {
+        packets[i].inlen = packets[i].outlen;
+        packets[i].out = plain + (size_t)i * (MAX_PACKET + CRYPTO_ABYTES);
+    }
+
+    printf("%d sessions, %d-%d byte packets, %d passes over %d packets\n",
+        NUM_SESSIONS, MIN_PACKET, MAX_PACKET, passes, NUM_PACKETS);
+
+    rapl_t rapl;
+    int have_rapl = rapl_open(&rapl) == 0 && rapl_measure_idle(&rapl, RAPL_IDLE_MS) == 0;
+    if (have_rapl) {
+        printf("Energy: RAPL %s, idle %.0f mW subtracted\n", rapl.zone, rapl.idle_mw);
+    } else {
+        printf("Energy: no RAPL access, no nJ/byte figures\n");
+    }
+
+    size_t failed = 0;
+    uint64_t energy_before;
+    const rapl_t* energy = have_rapl && rapl_read(&rapl, &energy_before) == 0 ? &rapl : NULL;
+    double start = bench_seconds();
+    for (int pass = 0; pass < passes; pass++) {
+        for (int i = 0; i < NUM_PACKETS; i++) {
+            failed += decrypt_one(variant, keys[owner[i]], &packets[i]) != 0;
+        }
+    }
+    double elapsed = bench_seconds() - start;
+    printf("One packet per call: %f packets/s (%zu failed)", (double)passes * NUM_PACKETS / elapsed, failed);
+    print_energy(energy, energy_before, elapsed, passes * payload_bytes);
+
+    failed = 0;
+    energy = have_rapl && rapl_read(&rapl, &energy_before) == 0 ? &rapl : NULL;
+    start = bench_seconds();
+    for (int pass = 0; pass < passes; pass++) {
+        failed += ascon_decrypt_batch(packets, NUM_PACKETS);
+    }
+    elapsed = bench_seconds() - start;
+    printf("Batch API:           %f packets/s (%zu failed)", (double)passes * NUM_PACKETS / elapsed, failed);
+    print_energy(energy, energy_before, elapsed, passes * payload_bytes);
+
+    free(keys);
+    free(sessions);
+    free(packets);
+    free(owner);
+    free(data);
+    free(plain);
+    return 0;
+}
@@ -7,8 +7,10 @@
 #include "constants.h"
 #include "printstate.h"
 #include "round.h"
+#include "trace.h"
 
 static inline void P12(ascon_state_t* s) {
+  ASCON_TRACE_PERM_BEGIN(12);
   ROUND(s, 0xf0);
   ROUND(s, 0xe1);
   ROUND(s, 0xd2);
@@ -21,9 +23,11 @@ static inline void P12(ascon_state_t* s) {
   ROUND(s, 0x69);
   ROUND(s, 0x5a);
   ROUND(s, 0x4b);
+  ASCON_TRACE_PERM_END(12);
 }
 
 static inline void P8(ascon_state_t* s) {
+  ASCON_TRACE_PERM_BEGIN(8);
   ROUND(s, 0xb4);
   ROUND(s, 0xa5);
   ROUND(s, 0x96);
@@ -32,15 +36,18 @@ static inline void P8(ascon_state_t* s) {
   ROUND(s, 0x69);
   ROUND(s, 0x5a);
   ROUND(s, 0x4b);
+  ASCON_TRACE_PERM_END(8);
 }
 
 static inline void P6(ascon_state_t* s) {
+  ASCON_TRACE_PERM_BEGIN(6);
   ROUND(s, 0x96);
   ROUND(s, 0x87);
   ROUND(s, 0x78);
   ROUND(s, 0x69);
   ROUND(s, 0x5a);
   ROUND(s, 0x4b);
+  ASCON_TRACE_PERM_END(6);
 }
 
 #endif /* PERMUTATIONS_H_ */
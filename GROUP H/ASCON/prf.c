@@ -0,0 +1,141 @@
+#include "prf.h"
+
+#include "api.h"
+#include "ascon.h"
+#include "constants.h"
+#include "permutations.h"
+#include "printstate.h"
+#include "word.h"
+
+static void ascon_prf_initialize(ascon_state_t* s, uint64_t iv, uint64_t K0,
+                                 uint64_t K1) {
+  s->x[0] = iv;
+  s->x[1] = K0;
+  s->x[2] = K1;
+  s->x[3] = 0;
+  s->x[4] = 0;
+  printstate("initial value", s);
+  P12(s);
+  printstate("initialization", s);
+}
+
+void ascon_prf_setkey(ascon_prf_key_t* key, const uint8_t* k) {
+  key->K0 = LOADBYTES(k, 8);
+  key->K1 = LOADBYTES(k + 8, 8);
+  ascon_prf_initialize(&key->prf, ASCON_PRF_IV, key->K0, key->K1);
+  ascon_prf_initialize(&key->mac, ASCON_MAC_IV, key->K0, key->K1);
+}
+
+static void ascon_prf_absorb(ascon_state_t* s, const uint8_t* in,
+                             size_t inlen) {
+  int i = 0;
+  /* absorb full input blocks */
+  while (inlen >= ASCON_PRF_IN_RATE) {
+    s->x[0] ^= LOADBYTES(in, 8);
+    s->x[1] ^= LOADBYTES(in + 8, 8);
+    s->x[2] ^= LOADBYTES(in + 16, 8);
+    s->x[3] ^= LOADBYTES(in + 24, 8);
+    printstate("absorb input", s);
+    P12(s);
+    in += ASCON_PRF_IN_RATE;
+    inlen -= ASCON_PRF_IN_RATE;
+  }
+  /* absorb final input block */
+  while (inlen >= 8) {
+    s->x[i++] ^= LOADBYTES(in, 8);
+    in += 8;
+    inlen -= 8;
+  }
+  s->x[i] ^= LOADBYTES(in, (int)inlen);
+  s->x[i] ^= PAD(inlen);
+  /* domain separation */
+  s->x[4] ^= DSEP();
+  printstate("domain separation", s);
+  P12(s);
+}
+
+static void ascon_prf_squeeze(ascon_state_t* s, uint8_t* out,
+                              size_t outlen) {
+  /* squeeze full output blocks */
+  while (outlen > ASCON_PRF_OUT_RATE) {
+    STOREBYTES(out, s->x[0], 8);
+    STOREBYTES(out + 8, s->x[1], 8);
+    printstate("squeeze output", s);
+    P12(s);
+    out += ASCON_PRF_OUT_RATE;
+    outlen -= ASCON_PRF_OUT_RATE;
+  }
+  /* squeeze final output block */
+  if (outlen > 8) {
+    STOREBYTES(out, s->x[0], 8);
+    STOREBYTES(out + 8, s->x[1], (int)outlen - 8);
+  } else {
+    STOREBYTES(out, s->x[0], (int)outlen);
+  }
+}
+
+int ascon_prf(const ascon_prf_key_t* key, uint8_t* out, size_t outlen,
+              const uint8_t* in, size_t inlen) {
+  ascon_state_t s = key->prf;
+  ascon_prf_absorb(&s, in, inlen);
+  ascon_prf_squeeze(&s, out, outlen);
+  return 0;
+}
+
+int ascon_mac(const ascon_prf_key_t* key, uint8_t* tag, const uint8_t* in,
+              size_t inlen) {
+  ascon_state_t s = key->mac;
+  ascon_prf_absorb(&s, in, inlen);
+  ascon_prf_squeeze(&s, tag, ASCON_PRF_BYTES);
+  return 0;
+}
+
+/* verify should be constant time, check compiler output */
+static int ascon_verify_tag(const uint8_t* tag, const uint8_t* t) {
+  int i;
+  int result = 0;
+  for (i = 0; i < ASCON_PRF_BYTES; ++i) result |= tag[i] ^ t[i];
+  return (((result - 1) >> 8) & 1) - 1;
+}
+
+int ascon_mac_verify(const ascon_prf_key_t* key, const uint8_t* tag,
+                     const uint8_t* in, size_t inlen) {
+  uint8_t t[ASCON_PRF_BYTES];
+  ascon_mac(key, t, in, inlen);
+  return ascon_verify_tag(tag, t);
+}
+
+int ascon_prfs(const ascon_prf_key_t* key, uint8_t* tag, const uint8_t* in,
+               size_t inlen) {
+  if (inlen > ASCON_PRFS_MAX_INLEN) return -1;
+
+  /* initialize with the message length in the IV and the message in x3/x4 */
+  ascon_state_t s;
+  s.x[0] = ASCON_PRFS_IV | ((uint64_t)(inlen * 8) << 48);
+  s.x[1] = key->K0;
+  s.x[2] = key->K1;
+  if (inlen > 8) {
+    s.x[3] = LOADBYTES(in, 8);
+    s.x[4] = LOADBYTES(in + 8, (int)inlen - 8);
+  } else {
+    s.x[3] = LOADBYTES(in, (int)inlen);
+    s.x[4] = 0;
+  }
+  printstate("initial value", &s);
+  P12(&s);
+  s.x[3] ^= key->K0;
+  s.x[4] ^= key->K1;
+  printstate("final key xor", &s);
+
+  /* get tag */
+  STOREBYTES(tag, s.x[3], 8);
+  STOREBYTES(tag + 8, s.x[4], 8);
+  return 0;
+}
+
+int ascon_prfs_verify(const ascon_prf_key_t* key, const uint8_t* tag,
+                      const uint8_t* in, size_t inlen) {
+  uint8_t t[ASCON_PRF_BYTES];
+  if (ascon_prfs(key, t, in, inlen)) return -1;
+  return ascon_verify_tag(tag, t);
+}
@@ -0,0 +1,41 @@
+#ifndef PRF_H_
+#define PRF_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "api.h"
+#include "ascon.h"
+
+#define ASCON_PRF_BYTES 16
+#define ASCON_PRFS_MAX_INLEN 16
+
+/* Key with the post-initialization states of Ascon-PRF and Ascon-MAC.
+ * IV || K || 0 does not depend on the message, so the first P12 runs once
+ * per key instead of once per message. */
+typedef struct {
+  uint64_t K0, K1;
+  ascon_state_t prf;
+  ascon_state_t mac;
+} ascon_prf_key_t;
+
+void ascon_prf_setkey(ascon_prf_key_t* key, const uint8_t* k);
+
+/* Ascon-PRF: arbitrary input and output length */
+int ascon_prf(const ascon_prf_key_t* key, uint8_t* out, size_t outlen,
+              const uint8_t* in, size_t inlen);
+
+/* Ascon-MAC: 16-byte tag */
+int ascon_mac(const ascon_prf_key_t* key, uint8_t* tag, const uint8_t* in,
+              size_t inlen);
+int ascon_mac_verify(const ascon_prf_key_t* key, const uint8_t* tag,
+                     const uint8_t* in, size_t inlen);
+
+/* Ascon-PRFshort: one P12 for inputs of at most 16 bytes, 16-byte tag.
+ * Returns -1 if inlen > ASCON_PRFS_MAX_INLEN. */
+int ascon_prfs(const ascon_prf_key_t* key, uint8_t* tag, const uint8_t* in,
+               size_t inlen);
+int ascon_prfs_verify(const ascon_prf_key_t* key, const uint8_t* tag,
+                      const uint8_t* in, size_t inlen);
+
+#endif /* PRF_H_ */
@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "prf.h"
+
+#define MAX_MSG 80 // several 32-byte input blocks plus every partial length
+#define MAX_OUT 64
+
+// FNV-1a over the outputs of an independent implementation of the Ascon v1.2 PRF
+// specification (key 00 01 .. 0f, message byte i = 3i + 1), all input lengths 0..MAX_MSG
+#define PRF_CHECKSUM 0x316dd954u  // every output length of out_lengths
+#define MAC_CHECKSUM 0x56318f8bu
+#define PRFS_CHECKSUM 0x2c17e858u // input lengths 0..ASCON_PRFS_MAX_INLEN
+
+static const size_t out_lengths[] = { 1, 7, 8, 15, 16, 17, 31, 32, 33, 48, 64 };
+#define NUM_OUT_LENGTHS ((int)(sizeof(out_lengths) / sizeof(out_lengths[0])))
+
+// Count = 1 of the KATs: empty input, key 00 01 .. 0f (PRFshort also with input 00 01 .. 0f)
+static const uint8_t kat_prf[32] = {
+    0x2a, 0x76, 0x6f, 0xe9, 0xa4, 0x89, 0x40, 0x73, 0xbc, 0x81, 0x1b, 0x19, 0xd5, 0x4a, 0xc3, 0x3d,
+    0xa3, 0x78, 0x1e, 0x8f, 0xa3, 0xf5, 0x48, 0xbf, 0x5c, 0xd8, 0xd8, 0x55, 0x55, 0x59, 0xe6, 0xb7 };
+static const uint8_t kat_mac[ASCON_PRF_BYTES] = {
+    0xeb, 0x1a, 0xf6, 0x88, 0x82, 0x5d, 0x66, 0xbf, 0x2d, 0x53, 0xe1, 0x35, 0xf9, 0x32, 0x33, 0x15 };
+static const uint8_t kat_prfs[ASCON_PRF_BYTES] = {
+    0x50, 0x06, 0xeb, 0x18, 0x08, 0x19, 0x38, 0x09, 0xf9, 0x81, 0x15, 0x1b, 0x19, 0xe5, 0x92, 0x99 };
+static const uint8_t kat_prfs16[ASCON_PRF_BYTES] = {
+    0xbd, 0x03, 0xea, 0x33, 0x4b, 0xeb, 0xef, 0xc4, 0xd7, 0xdd, 0xae, 0xf4, 0xb1, 0xdf, 0x14, 0x85 };
+
+static uint8_t msg[MAX_MSG];
+
+static uint32_t fnv(uint32_t checksum, const uint8_t* p, size_t len) {
+    for (size_t i = 0; i < len; i++) {
+        checksum = (checksum ^ p[i]) * 16777619u;
+    }
+    return checksum;
+}
+
+static int check_bytes(const char* name, const uint8_t* actual, const uint8_t* expected, size_t len) {
+    if (memcmp(actual, expected, len) != 0) {
+        printf("%s: KAT differs\n", name);
+        return 1;
+    }
+    return 0;
+}
+
+static int check_checksum(const char* name, uint32_t checksum, uint32_t expected) {
+    printf("%s: checksum %08lx, expected %08lx\n", name, (unsigned long)checksum, (unsigned long)expected);
+    return checksum != expected;
+}
+
+// A valid tag is accepted and every single flipped bit of it rejected
+typedef int (*VerifyFunc)(const ascon_prf_key_t*, const uint8_t*, const uint8_t*, size_t);
+static int check_verify(const char* name, VerifyFunc verify, const ascon_prf_key_t* key, const uint8_t* tag,
+                        size_t len) {
+    uint8_t bad[ASCON_PRF_BYTES];
+    int failures = 0;
+
+    if (verify(key, tag, msg, len) != 0) {
+        printf("%s: valid tag rejected (length %d)\n", name, (int)len);
+        failures++;
+    }
+    for (int bit = 0; bit < 8 * ASCON_PRF_BYTES; bit++) {
+        memcpy(bad, tag, ASCON_PRF_BYTES);
+        bad[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+        if (verify(key, bad, msg, len) == 0) {
+            printf("%s: flipped tag bit %d accepted (length %d)\n", name, bit, (int)len);
+            failures++;
+        }
+    }
+    return failures;
+}
+
+int main(void) {
+    uint8_t k[CRYPTO_KEYBYTES], out[MAX_OUT], longest[MAX_OUT], tag[ASCON_PRF_BYTES];
+    ascon_prf_key_t key;
+    uint32_t checksum;
+    int failures = 0;
+
+    for (int i = 0; i < CRYPTO_KEYBYTES; i++) k[i] = (uint8_t)i;
+    for (int i = 0; i < MAX_MSG; i++) msg[i] = (uint8_t)(3 * i + 1);
+    ascon_prf_setkey(&key, k);
+
+    printf("Checking prf.c\n");
+    ascon_prf(&key, out, sizeof(kat_prf), msg, 0);
+    failures += check_bytes("Ascon-PRF", out, kat_prf, sizeof(kat_prf));
+    ascon_mac(&key, out, msg, 0);
+    failures += check_bytes("Ascon-MAC", out, kat_mac, sizeof(kat_mac));
+    ascon_prfs(&key, out, msg, 0);
+    failures += check_bytes("Ascon-PRFshort", out, kat_prfs, sizeof(kat_prfs));
+    ascon_prfs(&key, out, k, sizeof(k));
+    failures += check_bytes("Ascon-PRFshort (16 bytes)", out, kat_prfs16, sizeof(kat_prfs16));
+
+    // PRF: every output length, each a prefix of the longest output
+    checksum = 2166136261u;
+    for (int len = 0; len <= MAX_MSG; len++) {
+        ascon_prf(&key, longest, MAX_OUT, msg, len);
+        for (int o = 0; o < NUM_OUT_LENGTHS; o++) {
+            memset(out, 0, sizeof(out));
+            ascon_prf(&key, out, out_lengths[o], msg, len);
+            if (memcmp(out, longest, out_lengths[o]) != 0) {
+                printf("Ascon-PRF: %d-byte output is not a prefix of the %d-byte one (length %d)\n",
+                       (int)out_lengths[o], MAX_OUT, len);
+                failures++;
+            }
+            checksum = fnv(checksum, out, out_lengths[o]);
+        }
+    }
+    failures += check_checksum("Ascon-PRF", checksum, PRF_CHECKSUM);
+
+    checksum = 2166136261u;
+    for (int len = 0; len <= MAX_MSG; len++) {
+        ascon_mac(&key, tag, msg, len);
+        checksum = fnv(checksum, tag, sizeof(tag));
+        failures += check_verify("Ascon-MAC", ascon_mac_verify, &key, tag, len);
+    }
+    failures += check_checksum("Ascon-MAC", checksum, MAC_CHECKSUM);
+
+    checksum = 2166136261u;
+    for (int len = 0; len <= ASCON_PRFS_MAX_INLEN; len++) {
+        if (ascon_prfs(&key, tag, msg, len) != 0) {
+            printf("Ascon-PRFshort: rejected a %d-byte input\n", len);
+            failures++;
+        }
+        checksum = fnv(checksum, tag, sizeof(tag));
+        failures += check_verify("Ascon-PRFshort", ascon_prfs_verify, &key, tag, len);
+    }
+    failures += check_checksum("Ascon-PRFshort", checksum, PRFS_CHECKSUM);
+    if (ascon_prfs(&key, tag, msg, ASCON_PRFS_MAX_INLEN + 1) == 0 ||
+        ascon_prfs_verify(&key, tag, msg, ASCON_PRFS_MAX_INLEN + 1) == 0) {
+        printf("Ascon-PRFshort: accepted a %d-byte input\n", ASCON_PRFS_MAX_INLEN + 1);
+        failures++;
+    }
+
+    printf(failures ? "FAILED\n" : "OK\n");
+    return failures ? 1 : 0;
+}
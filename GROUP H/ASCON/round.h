@@ -4,11 +4,14 @@
 #include "ascon.h"
 #include "constants.h"
 #include "printstate.h"
+#include "trace.h"
 
 static inline uint64_t ROR(uint64_t x, int n) {
   return x >> n | x << (-n & 63);
 }
 
+#ifdef ASCON_PORTABLE
+
 static inline void ROUND(ascon_state_t* s, uint8_t C) {
   ascon_state_t t;
   /* addition of round constant */
@@ -37,6 +40,56 @@ static inline void ROUND(ascon_state_t* s, uint8_t C) {
   s->x[3] = t.x[3] ^ ROR(t.x[3], 10) ^ ROR(t.x[3], 17);
   s->x[4] = t.x[4] ^ ROR(t.x[4], 7) ^ ROR(t.x[4], 41);
   printstate(" round output", s);
+  ASCON_TRACE_ROUND();
+}
+
+#else
+
+/* Same round with the s-box evaluated in place: chi needs only one saved
+ * term (x0 & ~x4) because the words it reads after updating them are
+ * unchanged where it matters, and each linear layer line is written as
+ * x ^= ROR(x ^ ROR(x, b - a), a). That keeps 5 state words plus 2 temporaries
+ * live instead of 10, which avoids spills on x86-64 and 32-bit targets. */
+static inline void ROUND(ascon_state_t* s, uint8_t C) {
+  uint64_t x0 = s->x[0], x1 = s->x[1], x2 = s->x[2], x3 = s->x[3],
+           x4 = s->x[4];
+  uint64_t t0, t1;
+  /* addition of round constant */
+  x2 ^= C;
+  /* substitution layer */
+  x0 ^= x4;
+  x4 ^= x3;
+  x2 ^= x1;
+  t0 = x0 & ~x4;
+  x0 ^= x2 & ~x1;
+  x2 ^= x4 & ~x3;
+  x4 ^= x1 & ~x0;
+  x1 ^= x3 & ~x2;
+  x3 ^= t0;
+  x1 ^= x0;
+  x3 ^= x2;
+  x0 ^= x4;
+  x2 = ~x2;
+  /* linear diffusion layer */
+  t0 = x0 ^ ROR(x0, 28 - 19);
+  x0 ^= ROR(t0, 19);
+  t1 = x1 ^ ROR(x1, 61 - 39);
+  x1 ^= ROR(t1, 39);
+  t0 = x2 ^ ROR(x2, 6 - 1);
+  x2 ^= ROR(t0, 1);
+  t1 = x3 ^ ROR(x3, 17 - 10);
+  x3 ^= ROR(t1, 10);
+  t0 = x4 ^ ROR(x4, 41 - 7);
+  x4 ^= ROR(t0, 7);
+  s->x[0] = x0;
+  s->x[1] = x1;
+  s->x[2] = x2;
+  s->x[3] = x3;
+  s->x[4] = x4;
+  printstate(" round output", s);
+  ASCON_TRACE_ROUND();
 }
 
+#endif /* ASCON_PORTABLE */
+
 #endif /* ROUND_H_ */
@@ -0,0 +1,123 @@
+#include "testdata.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "bench.h"
+#include "hash.h"
+#include "word.h"
+
+#define TESTDATA_PIECE (1024 * 1024)
+
+static const char testdata_label[] = "ECE4300 testdata";
+
+static inline uint64_t testdata_mix(uint64_t x) {
+  x ^= x >> 30;
+  x *= 0xbf58476d1ce4e5b9ull;
+  x ^= x >> 27;
+  x *= 0x94d049bb133111ebull;
+  x ^= x >> 31;
+  return x;
+}
+
+static inline uint64_t testdata_word(const testdata_stream_t* s, uint64_t j) {
+  return testdata_mix(s->k[j & 3] + j);
+}
+
+uint64_t testdata_seed(void) {
+  const char* env = getenv("TESTDATA_SEED");
+  return env && *env ? strtoull(env, NULL, 0) : TESTDATA_DEFAULT_SEED;
+}
+
+void testdata_stream(testdata_stream_t* s, uint64_t seed, uint64_t stream) {
+  uint8_t in[sizeof(testdata_label) - 1 + 16], out[32];
+  int i;
+  memcpy(in, testdata_label, sizeof(testdata_label) - 1);
+  STOREBYTES(in + sizeof(testdata_label) - 1, seed, 8);
+  STOREBYTES(in + sizeof(testdata_label) - 1 + 8, stream, 8);
+  ascon_xof(out, sizeof(out), in, sizeof(in));
+  for (i = 0; i < 4; ++i) s->k[i] = LOADBYTES(out + 8 * i, 8);
+}
+
+void testdata_fill(const testdata_stream_t* s, uint64_t offset, void* dst,
+                   size_t len) {
+  uint8_t* p = (uint8_t*)dst;
+  uint8_t w[8];
+  uint64_t j = offset / 8;
+  size_t n;
+  /* leading partial word */
+  if (offset % 8 && len) {
+    n = 8 - offset % 8;
+    if (n > len) n = len;
+    STOREBYTES(w, testdata_word(s, j++), 8);
+    memcpy(p, w + offset % 8, n);
+    p += n;
+    len -= n;
+  }
+  for (; len >= 8 && j % 4; len -= 8, p += 8)
+    STOREBYTES(p, testdata_word(s, j++), 8);
+  /* whole words, four lanes at a time */
+  if (len >= 32) {
+    uint64_t k0 = s->k[0], k1 = s->k[1], k2 = s->k[2], k3 = s->k[3];
+    size_t blocks = len / 32, b;
+    for (b = 0; b < blocks; ++b, j += 4, p += 32) {
+      STOREBYTES(p, testdata_mix(k0 + j), 8);
+      STOREBYTES(p + 8, testdata_mix(k1 + j + 1), 8);
+      STOREBYTES(p + 16, testdata_mix(k2 + j + 2), 8);
+      STOREBYTES(p + 24, testdata_mix(k3 + j + 3), 8);
+    }
+    len -= blocks * 32;
+  }
+  for (; len >= 8; len -= 8, p += 8) STOREBYTES(p, testdata_word(s, j++), 8);
+  /* trailing partial word */
+  if (len) {
+    STOREBYTES(w, testdata_word(s, j), 8);
+    memcpy(p, w, len);
+  }
+}
+
+typedef struct {
+  const testdata_stream_t* s;
+  uint8_t* dst;
+  size_t len;
+} testdata_job_t;
+
+static uint64_t testdata_piece(bench_thread_t* t, uint64_t unit) {
+  const testdata_job_t* job = (const testdata_job_t*)t->config->arg;
+  uint64_t offset = unit * TESTDATA_PIECE;
+  size_t n = job->len - offset < TESTDATA_PIECE ? job->len - offset
+                                                 : TESTDATA_PIECE;
+  testdata_fill(job->s, offset, job->dst + offset, n);
+  return n;
+}
+
+int testdata_fill_parallel(const testdata_stream_t* s, void* dst, size_t len,
+                           int num_threads) {
+  testdata_job_t job;
+  bench_config_t config;
+  bench_result_t result;
+  if (num_threads <= 1 || len <= TESTDATA_PIECE) {
+    testdata_fill(s, 0, dst, len);
+    return 0;
+  }
+  job.s = s;
+  job.dst = (uint8_t*)dst;
+  job.len = len;
+  memset(&config, 0, sizeof(config));
+  config.num_threads = num_threads;
+  config.units = (len + TESTDATA_PIECE - 1) / TESTDATA_PIECE;
+  config.pin = 1;
+  config.run = testdata_piece;
+  config.arg = &job;
+  if (bench_run(&config, &result, NULL)) {
+    testdata_fill(s, 0, dst, len);
+    return -1;
+  }
+  return 0;
+}
+
+void testdata_bytes(uint64_t stream, void* dst, size_t len) {
+  testdata_stream_t s;
+  testdata_stream(&s, testdata_seed(), stream);
+  testdata_fill(&s, 0, dst, len);
+}
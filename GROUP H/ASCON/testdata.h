@@ -0,0 +1,53 @@
+#ifndef TESTDATA_H_
+#define TESTDATA_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* Reproducible benchmark inputs. A stream is a function of (seed, stream
+ * number): its keys are squeezed from Ascon-XOF(label || seed || stream),
+ * and byte i of the stream is part of the 64-bit word
+ *
+ *   w[j] = mix(k[j % 4] + j),   j = i / 8, stored big-endian (word.h)
+ *
+ * where mix() is the SplitMix64 finalizer. Every word depends only on its
+ * position, so the same bytes come out on every platform, for any thread
+ * count and for any split of a buffer into pieces, and the four
+ * independent lanes per loop iteration let the compiler vectorize the fill.
+ * One core produces several GB/s; the XOF alone would manage 8 bytes per
+ * P12. This is test data, not a cryptographic random generator.
+ *
+ * The seed is TESTDATA_DEFAULT_SEED unless the environment variable
+ * TESTDATA_SEED is set, so reruns see the same inputs. */
+
+#define TESTDATA_DEFAULT_SEED 4300
+
+/* stream numbers shared by the benchmarks */
+#define TESTDATA_KEY 1
+#define TESTDATA_NONCE 2
+#define TESTDATA_AD 3
+#define TESTDATA_MESSAGE 4
+#define TESTDATA_THREAD(i) (0x100 + (uint64_t)(i)) /* per-thread data */
+
+typedef struct {
+  uint64_t k[4];
+} testdata_stream_t;
+
+/* TESTDATA_SEED from the environment, TESTDATA_DEFAULT_SEED otherwise */
+uint64_t testdata_seed(void);
+
+void testdata_stream(testdata_stream_t* s, uint64_t seed, uint64_t stream);
+
+/* bytes offset .. offset + len - 1 of the stream */
+void testdata_fill(const testdata_stream_t* s, uint64_t offset, void* dst,
+                   size_t len);
+
+/* same, split over threads (1 MB pieces); returns 0, -1 if the threads
+ * could not be started (dst is then filled by the calling thread) */
+int testdata_fill_parallel(const testdata_stream_t* s, void* dst, size_t len,
+                           int num_threads);
+
+/* stream number `stream` of testdata_seed(), from its start */
+void testdata_bytes(uint64_t stream, void* dst, size_t len);
+
+#endif /* TESTDATA_H_ */
@@ -0,0 +1,88 @@
+#ifdef ASCON_TRACE
+
+#include "trace.h"
+
+#include <inttypes.h>
+#include <string.h>
+#include <time.h>
+
+ASCON_TRACE_TLS ascon_trace_t ascon_trace_data;
+
+static const char* trace_phase_name[ASCON_TRACE_PHASES] = {
+    "other", "init", "adata", "message", "final"};
+static const char* trace_perm_name[ASCON_TRACE_PERMS] = {"P12", "P8", "P6"};
+static const int trace_perm_rounds[ASCON_TRACE_PERMS] = {12, 8, 6};
+
+#ifdef ASCON_TRACE_NO_TSC
+uint64_t ascon_trace_time(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+#endif
+
+ascon_trace_t* ascon_trace_get(void) { return &ascon_trace_data; }
+
+void ascon_trace_reset(void) {
+  memset(&ascon_trace_data, 0, sizeof(ascon_trace_data));
+}
+
+void ascon_trace_merge(ascon_trace_counts_t* total,
+                       const ascon_trace_counts_t* counts) {
+  int p, k;
+  total->rounds += counts->rounds;
+  for (p = 0; p < ASCON_TRACE_PHASES; ++p) {
+    total->phase_calls[p] += counts->phase_calls[p];
+    total->phase_bytes[p] += counts->phase_bytes[p];
+    total->phase_cycles[p] += counts->phase_cycles[p];
+    for (k = 0; k < ASCON_TRACE_PERMS; ++k) {
+      total->perm_calls[p][k] += counts->perm_calls[p][k];
+      total->perm_cycles[p][k] += counts->perm_cycles[p][k];
+    }
+  }
+}
+
+void ascon_trace_report(FILE* f, const ascon_trace_counts_t* c) {
+  uint64_t rounds = 0, cycles = 0;
+  int p, k;
+  for (p = 0; p < ASCON_TRACE_PHASES; ++p) {
+    cycles += c->phase_cycles[p];
+    for (k = 0; k < ASCON_TRACE_PERMS; ++k)
+      rounds += c->perm_calls[p][k] * trace_perm_rounds[k];
+  }
+  fprintf(f, "trace: %" PRIu64 " rounds (%" PRIu64 " in P12/P8/P6)\n",
+          c->rounds, rounds);
+  fprintf(f, "%-8s %12s %14s %14s %6s  %s\n", "phase", "calls", "bytes",
+          "cycles", "%", "permutations (calls, cycles)");
+  for (p = 0; p < ASCON_TRACE_PHASES; ++p) {
+    if (!c->phase_calls[p] && !c->perm_calls[p][0] && !c->perm_calls[p][1] &&
+        !c->perm_calls[p][2])
+      continue;
+    fprintf(f, "%-8s %12" PRIu64 " %14" PRIu64 " %14" PRIu64 " %6.1f ",
+            trace_phase_name[p], c->phase_calls[p], c->phase_bytes[p],
+            c->phase_cycles[p],
+            cycles ? 100.0 * c->phase_cycles[p] / cycles : 0.0);
+    for (k = 0; k < ASCON_TRACE_PERMS; ++k)
+      if (c->perm_calls[p][k])
+        fprintf(f, " %s %" PRIu64 " %" PRIu64, trace_perm_name[k],
+                c->perm_calls[p][k], c->perm_cycles[p][k]);
+    fprintf(f, "\n");
+  }
+}
+
+void ascon_trace_dump(FILE* f, const ascon_trace_t* t, int max_events) {
+  static const char* event_name[4] = {"?", "enter", "leave", "perm"};
+  uint64_t first = 0, i, start;
+  if (t->events > ASCON_TRACE_RING) first = t->events - ASCON_TRACE_RING;
+  if (max_events >= 0 && t->events - first > (uint64_t)max_events)
+    first = t->events - max_events;
+  if (first == t->events) return;
+  start = t->ring[first & (ASCON_TRACE_RING - 1)].time;
+  for (i = first; i < t->events; ++i) {
+    const ascon_trace_event_t* e = &t->ring[i & (ASCON_TRACE_RING - 1)];
+    fprintf(f, "%12" PRIu64 " %-5s %-8s %" PRIu32 "\n", e->time - start,
+            event_name[e->event & 3], trace_phase_name[e->phase], e->arg);
+  }
+}
+
+#endif
@@ -0,0 +1,195 @@
+#ifndef TRACE_H_
+#define TRACE_H_
+
+/* Compile-time selectable tracing of the permutation and the AEAD phases.
+ *
+ *   not defined       every hook compiles to nothing (default)
+ *   -DASCON_TRACE=1   counters only: rounds, P12/P8/P6 calls and, per
+ *                     phase, calls and bytes
+ *   -DASCON_TRACE=2   also timestamps: cycles spent in each phase and in
+ *                     each permutation within a phase, and a ring buffer of
+ *                     the last ASCON_TRACE_RING events
+ *
+ * The data is per thread (thread local), so hooks never contend. Level 1
+ * adds a few increments per permutation; level 2 reads the timestamp
+ * counter around every phase and permutation (about 20-40 cycles each on
+ * x86), so time a workload with level 1 or no tracing and use level 2 to
+ * see where that time goes. Link trace.c when ASCON_TRACE is defined.
+ *
+ * Phases are marked in ascon_aead.h (used by ascon_aead.c, aead_batch.c,
+ * aead_chunked.c, ...), aead_stream.c and the Ascon-128 code in
+ * aead_updated.c. Permutations from other code (hash, PRF, aead.c) count
+ * under ASCON_PHASE_NONE. The AVX2 engine has its own permutation and is
+ * not traced. */
+
+#include <stdint.h>
+
+#define ASCON_PHASE_NONE 0
+#define ASCON_PHASE_INIT 1  /* initialization incl. the first P12 */
+#define ASCON_PHASE_AD 2    /* associated data, padding, domain separation */
+#define ASCON_PHASE_MSG 3   /* plaintext/ciphertext blocks and padding */
+#define ASCON_PHASE_FINAL 4 /* finalization incl. the last P12 */
+#define ASCON_TRACE_PHASES 5
+
+#define ASCON_TRACE_P12 0
+#define ASCON_TRACE_P8 1
+#define ASCON_TRACE_P6 2
+#define ASCON_TRACE_PERMS 3
+
+#ifdef ASCON_TRACE
+
+#include <stdio.h>
+
+#ifndef ASCON_TRACE_RING
+#define ASCON_TRACE_RING 4096 /* events, power of 2 */
+#endif
+
+#define ASCON_EVENT_ENTER 1 /* arg: bytes of the phase */
+#define ASCON_EVENT_LEAVE 2
+#define ASCON_EVENT_PERM 3 /* arg: rounds */
+
+typedef struct {
+  uint64_t time; /* timestamp counter */
+  uint16_t event;
+  uint16_t phase;
+  uint32_t arg;
+} ascon_trace_event_t;
+
+typedef struct {
+  uint64_t rounds;
+  uint64_t phase_calls[ASCON_TRACE_PHASES];
+  uint64_t phase_bytes[ASCON_TRACE_PHASES];
+  uint64_t phase_cycles[ASCON_TRACE_PHASES]; /* level 2 */
+  uint64_t perm_calls[ASCON_TRACE_PHASES][ASCON_TRACE_PERMS];
+  uint64_t perm_cycles[ASCON_TRACE_PHASES][ASCON_TRACE_PERMS]; /* level 2 */
+} ascon_trace_counts_t;
+
+typedef struct {
+  ascon_trace_counts_t counts;
+  int phase;
+  uint64_t phase_start;
+  uint64_t perm_start;
+  uint64_t events; /* written so far, ring[events % ASCON_TRACE_RING] next */
+  ascon_trace_event_t ring[ASCON_TRACE_RING];
+} ascon_trace_t;
+
+#if defined(__cplusplus)
+#define ASCON_TRACE_TLS thread_local
+#elif defined(_MSC_VER)
+#define ASCON_TRACE_TLS __declspec(thread)
+#else
+#define ASCON_TRACE_TLS _Thread_local
+#endif
+
+extern ASCON_TRACE_TLS ascon_trace_t ascon_trace_data;
+
+/* the calling thread's trace */
+ascon_trace_t* ascon_trace_get(void);
+void ascon_trace_reset(void);
+
+/* total += counts, to combine threads */
+void ascon_trace_merge(ascon_trace_counts_t* total,
+                       const ascon_trace_counts_t* counts);
+
+/* table of phases and permutations (cycles only with level 2) */
+void ascon_trace_report(FILE* f, const ascon_trace_counts_t* counts);
+
+/* the last max_events events of the calling thread (level 2) */
+void ascon_trace_dump(FILE* f, const ascon_trace_t* t, int max_events);
+
+#if ASCON_TRACE >= 2
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define ASCON_TRACE_TIME() __rdtsc()
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <x86intrin.h>
+#define ASCON_TRACE_TIME() __rdtsc()
+#else
+#define ASCON_TRACE_NO_TSC
+uint64_t ascon_trace_time(void); /* nanoseconds where there is no TSC */
+#define ASCON_TRACE_TIME() ascon_trace_time()
+#endif
+
+static inline void ascon_trace_event(ascon_trace_t* t, uint64_t time,
+                                     int event, uint32_t arg) {
+  ascon_trace_event_t* e = &t->ring[t->events++ & (ASCON_TRACE_RING - 1)];
+  e->time = time;
+  e->event = (uint16_t)event;
+  e->phase = (uint16_t)t->phase;
+  e->arg = arg;
+}
+
+#endif
+
+static inline int ascon_trace_perm_index(int rounds) {
+  return rounds == 12 ? ASCON_TRACE_P12
+                      : rounds == 8 ? ASCON_TRACE_P8 : ASCON_TRACE_P6;
+}
+
+static inline void ascon_trace_enter(int phase, uint64_t bytes) {
+  ascon_trace_t* t = &ascon_trace_data;
+  t->phase = phase;
+  t->counts.phase_calls[phase]++;
+  t->counts.phase_bytes[phase] += bytes;
+#if ASCON_TRACE >= 2
+  t->phase_start = ASCON_TRACE_TIME();
+  ascon_trace_event(t, t->phase_start, ASCON_EVENT_ENTER, (uint32_t)bytes);
+#endif
+}
+
+static inline void ascon_trace_leave(void) {
+  ascon_trace_t* t = &ascon_trace_data;
+#if ASCON_TRACE >= 2
+  uint64_t now = ASCON_TRACE_TIME();
+  t->counts.phase_cycles[t->phase] += now - t->phase_start;
+  ascon_trace_event(t, now, ASCON_EVENT_LEAVE, 0);
+#endif
+  t->phase = ASCON_PHASE_NONE;
+}
+
+static inline void ascon_trace_perm_begin(int rounds) {
+  (void)rounds;
+#if ASCON_TRACE >= 2
+  ascon_trace_data.perm_start = ASCON_TRACE_TIME();
+#endif
+}
+
+static inline void ascon_trace_perm_end(int rounds) {
+  ascon_trace_t* t = &ascon_trace_data;
+  int i = ascon_trace_perm_index(rounds);
+  t->counts.perm_calls[t->phase][i]++;
+#if ASCON_TRACE >= 2
+  uint64_t now = ASCON_TRACE_TIME();
+  t->counts.perm_cycles[t->phase][i] += now - t->perm_start;
+  ascon_trace_event(t, now, ASCON_EVENT_PERM, (uint32_t)rounds);
+#endif
+}
+
+#define ASCON_TRACE_ENTER(phase, bytes) ascon_trace_enter((phase), (bytes))
+#define ASCON_TRACE_LEAVE() ascon_trace_leave()
+#define ASCON_TRACE_PERM_BEGIN(rounds) ascon_trace_perm_begin(rounds)
+#define ASCON_TRACE_PERM_END(rounds) ascon_trace_perm_end(rounds)
+#define ASCON_TRACE_ROUND() (ascon_trace_data.counts.rounds++)
+
+#else
+
+#define ASCON_TRACE_ENTER(phase, bytes) \
+  do {                                  \
+  } while (0)
+#define ASCON_TRACE_LEAVE() \
+  do {                      \
+  } while (0)
+#define ASCON_TRACE_PERM_BEGIN(rounds) \
+  do {                                 \
+  } while (0)
+#define ASCON_TRACE_PERM_END(rounds) \
+  do {                               \
+  } while (0)
+#define ASCON_TRACE_ROUND() \
+  do {                      \
+  } while (0)
+
+#endif /* ASCON_TRACE */
+
+#endif /* TRACE_H_ */
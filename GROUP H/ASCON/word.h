@@ -2,6 +2,14 @@
 #define WORD_H_
 
 #include <stdint.h>
+#include <string.h>
+
+/* Ascon words are big-endian. By default bytes are moved with native
+ * (unaligned) 64-bit loads and stores plus a byte swap where the compiler
+ * offers one; -DASCON_PORTABLE selects the byte-at-a-time reference code. */
+#if !defined(ASCON_PORTABLE) && (defined(__GNUC__) || defined(_MSC_VER))
+#define ASCON_NATIVE_WORDS
+#endif
 
 /* get byte from 64-bit Ascon word */
 #define GETBYTE(x, i) ((uint8_t)((uint64_t)(x) >> (56 - 8 * (i))))
@@ -15,6 +23,51 @@
 /* define domain separation bit in 64-bit Ascon word */
 #define DSEP() SETBYTE(0x01, 7)
 
+#ifdef ASCON_NATIVE_WORDS
+
+#ifdef _MSC_VER
+#include <stdlib.h>
+#define ASCON_BSWAP64(x) _byteswap_uint64(x)
+#else
+#define ASCON_BSWAP64(x) __builtin_bswap64(x)
+#endif
+
+/* native word <-> big-endian Ascon word */
+static inline uint64_t U64BIG(uint64_t x) {
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+  return x;
+#else
+  return ASCON_BSWAP64(x);
+#endif
+}
+
+/* load bytes into 64-bit Ascon word; bytes n..7 stay zero, so partial
+ * blocks never read past the end of the input */
+static inline uint64_t LOADBYTES(const uint8_t* bytes, int n) {
+  uint64_t x = 0;
+  if (n == 8)
+    memcpy(&x, bytes, 8);
+  else
+    memcpy(&x, bytes, n);
+  return U64BIG(x);
+}
+
+/* store bytes from 64-bit Ascon word */
+static inline void STOREBYTES(uint8_t* bytes, uint64_t x, int n) {
+  x = U64BIG(x);
+  if (n == 8)
+    memcpy(bytes, &x, 8);
+  else
+    memcpy(bytes, &x, n);
+}
+
+/* clear bytes in 64-bit Ascon word */
+static inline uint64_t CLEARBYTES(uint64_t x, int n) {
+  return n >= 8 ? 0 : x & (~(uint64_t)0 >> (8 * n));
+}
+
+#else
+
 /* load bytes into 64-bit Ascon word */
 static inline uint64_t LOADBYTES(const uint8_t* bytes, int n) {
   int i;
@@ -36,4 +89,6 @@ static inline uint64_t CLEARBYTES(uint64_t x, int n) {
   return x;
 }
 
+#endif /* ASCON_NATIVE_WORDS */
+
 #endif /* WORD_H_ */